@@ -0,0 +1,98 @@
+--[[
+    Compares per element TArray access with the bulk conversions ToTableFast/FromTable on 10k elements.
+
+    Run it from any script, e.g. in ReceiveBeginPlay:
+    require("Benchmarks.ArrayBulkConversion").Run()
+]] --
+
+local M = {}
+
+local NUM_ELEMENTS = 10000
+local NUM_ROUNDS = 20
+
+local function measure(name, fn)
+    fn() -- warm up
+    local start = os.clock()
+    for _ = 1, NUM_ROUNDS do
+        fn()
+    end
+    local elapsed = (os.clock() - start) * 1000 / NUM_ROUNDS
+    print(string.format("  %-28s %8.3f ms", name, elapsed))
+    return elapsed
+end
+
+local function compare(title, element_type, values)
+    print(title)
+
+    local array = UE.TArray.FromTable(values, element_type)
+    assert(array:Length() == #values)
+
+    local to_table = measure("Get per element", function()
+        local t = {}
+        for i = 1, array:Length() do
+            t[i] = array:Get(i)
+        end
+        return t
+    end)
+    local to_table_fast = measure("ToTableFast", function()
+        return array:ToTableFast()
+    end)
+
+    local from_table = measure("Add per element", function()
+        local a = UE.TArray(element_type)
+        for i = 1, #values do
+            a:Add(values[i])
+        end
+        return a
+    end)
+    local from_table_fast = measure("FromTable", function()
+        return UE.TArray.FromTable(values, element_type)
+    end)
+
+    print(string.format("  to table x%.1f, from table x%.1f", to_table / to_table_fast, from_table / from_table_fast))
+end
+
+function M.Run()
+    print(string.format("========== TArray bulk conversion, %d elements, %d rounds ==========", NUM_ELEMENTS, NUM_ROUNDS))
+
+    local integers, floats, vectors = {}, {}, {}
+    for i = 1, NUM_ELEMENTS do
+        integers[i] = i
+        floats[i] = i * 0.5
+    end
+    for i = 1, NUM_ELEMENTS * 3 do
+        vectors[i] = i * 0.25
+    end
+
+    compare("int32", 0, integers)
+    compare("float", 0.0, floats)
+
+    -- FVector arrays take and return flattened components
+    print("FVector")
+    local array = UE.TArray.FromTable(vectors, UE.FVector)
+    measure("Get per element", function()
+        local t = {}
+        for i = 1, array:Length() do
+            local v = array:Get(i)
+            t[#t + 1] = v.X
+            t[#t + 1] = v.Y
+            t[#t + 1] = v.Z
+        end
+        return t
+    end)
+    measure("ToTableFast", function()
+        return array:ToTableFast()
+    end)
+    measure("Add per element", function()
+        local a = UE.TArray(UE.FVector)
+        for i = 1, #vectors, 3 do
+            a:Add(UE.FVector(vectors[i], vectors[i + 1], vectors[i + 2]))
+        end
+        return a
+    end)
+    measure("FromTable", function()
+        return UE.TArray.FromTable(vectors, UE.FVector)
+    end)
+end
+
+return M
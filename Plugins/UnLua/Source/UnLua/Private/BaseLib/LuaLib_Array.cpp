@@ -16,6 +16,7 @@
 #include "UnLuaEx.h"
 #include "LuaCore.h"
 #include "Containers/LuaArray.h"
+#include "LuaInternalHeaders.h"
 
 static FORCEINLINE void TArray_Guard(lua_State* L, FLuaArray* Array)
 {
@@ -539,6 +540,246 @@ static int32 TArray_ToTable(lua_State* L)
     return 1;
 }
 
+/**
+ * Element types converted by the bulk kernels, FVector and FRotator are flattened to their components
+ */
+enum class EBulkElementType : uint8
+{
+    None,
+    Int32,
+    UInt8,
+    Float,
+    Double,
+    Vector,
+    Rotator,
+};
+
+typedef decltype(FVector::X) FVectorComponent;
+typedef decltype(FRotator::Pitch) FRotatorComponent;
+
+static EBulkElementType GetBulkElementType(const FLuaArray* Array)
+{
+    const FProperty* Property = Array->Inner->GetUProperty();
+    if (!Property)
+        return EBulkElementType::None;
+    if (Property->IsA<FIntProperty>())
+        return EBulkElementType::Int32;
+    if (Property->IsA<FByteProperty>())
+        return EBulkElementType::UInt8;
+    if (Property->IsA<FFloatProperty>())
+        return EBulkElementType::Float;
+    if (Property->IsA<FDoubleProperty>())
+        return EBulkElementType::Double;
+    if (const auto StructProperty = CastField<FStructProperty>(Property))
+    {
+        if (StructProperty->Struct == TBaseStructure<FVector>::Get())
+            return EBulkElementType::Vector;
+        if (StructProperty->Struct == TBaseStructure<FRotator>::Get())
+            return EBulkElementType::Rotator;
+    }
+    return EBulkElementType::None;
+}
+
+static FORCEINLINE int32 GetNumComponents(EBulkElementType Type)
+{
+    return Type == EBulkElementType::Vector || Type == EBulkElementType::Rotator ? 3 : 1;
+}
+
+template <typename T>
+static FORCEINLINE void WriteIntegers(TValue* Slots, const T* Src, int32 Num)
+{
+    for (int32 i = 0; i < Num; ++i)
+        setivalue(&Slots[i], (lua_Integer)Src[i]);
+}
+
+template <typename T>
+static FORCEINLINE void WriteNumbers(TValue* Slots, const T* Src, int32 Num)
+{
+    for (int32 i = 0; i < Num; ++i)
+        setfltvalue(&Slots[i], (lua_Number)Src[i]);
+}
+
+template <typename T>
+static FORCEINLINE typename TEnableIf<TIsIntegral<T>::Value, T>::Type FloatToNumber(lua_Number Value)
+{
+    // same as lua_tointeger, floats without an exact integer value in range are 0 rather than an undefined cast
+    lua_Integer Integer;
+    if (Value != FMath::FloorToDouble(Value) || !lua_numbertointeger(Value, &Integer))
+        return (T)0;
+    return (T)Integer;
+}
+
+template <typename T>
+static FORCEINLINE typename TEnableIf<!TIsIntegral<T>::Value, T>::Type FloatToNumber(lua_Number Value)
+{
+    return (T)Value;
+}
+
+template <typename T>
+static FORCEINLINE bool ToNumber(const TValue* Value, T& Dest)
+{
+    if (ttisinteger(Value))
+    {
+        Dest = (T)ivalue(Value);
+        return true;
+    }
+    if (ttisfloat(Value))
+    {
+        Dest = FloatToNumber<T>(fltvalue(Value));
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+static FORCEINLINE T ToNumber(lua_State* L, int32 TableIndex, int32 Index)
+{
+    // the conversions of TArray:Set, numeric strings included
+    lua_rawgeti(L, TableIndex, Index);
+    const T Value = TIsIntegral<T>::Value ? (T)lua_tointeger(L, -1) : FloatToNumber<T>(lua_tonumber(L, -1));
+    lua_pop(L, 1);
+    return Value;
+}
+
+template <typename T>
+static void ReadNumbers(lua_State* L, int32 TableIndex, T* Dest, int32 Num)
+{
+    // read the array part of the table directly if it covers all values, other than numbers go through the Lua API
+    const Table* Tbl = (const Table*)lua_topointer(L, TableIndex);
+    if ((unsigned int)Num <= Tbl->alimit)
+    {
+        const TValue* Slots = Tbl->array;
+        for (int32 i = 0; i < Num; ++i)
+        {
+            if (!ToNumber(&Slots[i], Dest[i]))
+                Dest[i] = ToNumber<T>(L, TableIndex, i + 1);
+        }
+        return;
+    }
+
+    for (int32 i = 0; i < Num; ++i)
+        Dest[i] = ToNumber<T>(L, TableIndex, i + 1);
+}
+
+/**
+ * Convert the array to a Lua table without per element dispatch, FVector and FRotator arrays are flattened to components
+ */
+static int32 TArray_ToTableFast(lua_State* L)
+{
+    int32 NumParams = lua_gettop(L);
+    if (NumParams != 1)
+        return luaL_error(L, "invalid parameters");
+
+    FLuaArray* Array = (FLuaArray*)(GetCppInstanceFast(L, 1));
+    TArray_Guard(L, Array);
+
+    const auto Type = GetBulkElementType(Array);
+    if (Type == EBulkElementType::None)
+        return TArray_ToTable(L);
+
+    const int32 NumValues = Array->Num() * GetNumComponents(Type);
+    lua_createtable(L, NumValues, 0);
+    if (NumValues == 0)
+        return 1;
+
+    // the array part is preallocated and numbers need no write barrier
+    TValue* Slots = ((Table*)lua_topointer(L, -1))->array;
+    const void* Data = Array->GetData();
+    switch (Type)
+    {
+    case EBulkElementType::Int32:
+        WriteIntegers(Slots, (const int32*)Data, NumValues);
+        break;
+    case EBulkElementType::UInt8:
+        WriteIntegers(Slots, (const uint8*)Data, NumValues);
+        break;
+    case EBulkElementType::Float:
+        WriteNumbers(Slots, (const float*)Data, NumValues);
+        break;
+    case EBulkElementType::Double:
+        WriteNumbers(Slots, (const double*)Data, NumValues);
+        break;
+    case EBulkElementType::Vector:
+        WriteNumbers(Slots, (const FVectorComponent*)Data, NumValues);
+        break;
+    case EBulkElementType::Rotator:
+        WriteNumbers(Slots, (const FRotatorComponent*)Data, NumValues);
+        break;
+    default:
+        check(false);
+        break;
+    }
+    return 1;
+}
+
+/**
+ * Create an array from a Lua sequence table, FVector and FRotator arrays take flattened components
+ */
+static int32 TArray_FromTable(lua_State* L)
+{
+    int32 NumParams = lua_gettop(L);
+    if (NumParams != 2)
+        return luaL_error(L, "invalid parameters");
+
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    auto& Env = UnLua::FLuaEnv::FindEnvChecked(L);
+    auto ElementType = Env.GetPropertyRegistry()->CreateTypeInterface(L, 2);
+    if (!ElementType)
+        return luaL_error(L, "invalid element type");
+
+    const int32 NumValues = (int32)lua_rawlen(L, 1);
+    FLuaArray* Array = Env.GetContainerRegistry()->NewArray(L, ElementType, FLuaArray::OwnedBySelf);
+    const auto Type = GetBulkElementType(Array);
+    if (Type == EBulkElementType::None)
+    {
+        Array->Reserve(NumValues);
+        for (int32 i = 1; i <= NumValues; ++i)
+        {
+            lua_rawgeti(L, 1, i);
+            const int32 Index = Array->AddDefaulted();
+            Array->Inner->WriteValue_InContainer(L, Array->GetData(Index), -1);
+            lua_pop(L, 1);
+        }
+        return 1;
+    }
+
+    const int32 NumComponents = GetNumComponents(Type);
+    if (NumValues % NumComponents != 0)
+        return luaL_error(L, "the number of values must be a multiple of %d", NumComponents);
+
+    if (NumValues == 0)
+        return 1;
+
+    Array->AddUninitialized(NumValues / NumComponents);
+    void* Data = Array->GetData();
+    switch (Type)
+    {
+    case EBulkElementType::Int32:
+        ReadNumbers(L, 1, (int32*)Data, NumValues);
+        break;
+    case EBulkElementType::UInt8:
+        ReadNumbers(L, 1, (uint8*)Data, NumValues);
+        break;
+    case EBulkElementType::Float:
+        ReadNumbers(L, 1, (float*)Data, NumValues);
+        break;
+    case EBulkElementType::Double:
+        ReadNumbers(L, 1, (double*)Data, NumValues);
+        break;
+    case EBulkElementType::Vector:
+        ReadNumbers(L, 1, (FVectorComponent*)Data, NumValues);
+        break;
+    case EBulkElementType::Rotator:
+        ReadNumbers(L, 1, (FRotatorComponent*)Data, NumValues);
+        break;
+    default:
+        check(false);
+        break;
+    }
+    return 1;
+}
+
 static int32 TArray_Index(lua_State* L)
 {
     if (lua_isinteger(L, 2))
@@ -585,6 +826,8 @@ static const luaL_Reg TArrayLib[] =
     {"Contains", TArray_Contains},
     {"Append", TArray_Append},
     {"ToTable", TArray_ToTable},
+    {"ToTableFast", TArray_ToTableFast},
+    {"FromTable", TArray_FromTable},
     {"__gc", TArray_Delete},
     {"__call", TArray_New},
     {"__pairs", TArray_Pairs},
@@ -0,0 +1,50 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "LuaAsyncHook.h"
+#include "LuaEnv.h"
+#include "LuaSampleProfiler.h"
+
+namespace UnLua
+{
+    FLuaAsyncHook::FLuaAsyncHook(lua_State* L)
+        : L(L), Pending(0)
+    {
+    }
+
+    void FLuaAsyncHook::Request(uint32 Requests)
+    {
+        Pending.fetch_or(Requests);
+        const auto Hook = lua_gethook(L);
+        if (Hook == nullptr || Hook == OnHook)
+            lua_sethook(L, OnHook, LUA_MASKCOUNT, 1);
+        else
+            Cancel(Requests);
+    }
+
+    void FLuaAsyncHook::OnHook(lua_State* L, lua_Debug* ar)
+    {
+        // 先卸载再取请求，其他线程此后的请求会重新挂钩，不会丢失
+        lua_sethook(L, nullptr, 0, 0);
+        const auto Env = FLuaEnv::FindEnv(L);
+        if (!Env)
+            return;
+
+        const uint32 Requests = Env->GetAsyncHook()->Pending.exchange(0);
+        if (Requests & Sample)
+            FSampleProfiler::Sample(L);
+        if (Requests & Timeout)
+            luaL_error(L, "lua script exec timeout");
+    }
+}
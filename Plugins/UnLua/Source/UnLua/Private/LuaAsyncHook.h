@@ -0,0 +1,56 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "lua.hpp"
+#include <atomic>
+
+namespace UnLua
+{
+    /**
+     * Count hook of the main thread shared by the checks and profilers interrupting Lua from other threads
+     *
+     * Any thread can post requests as atomic flags and arm the hook, all pending requests are served at the next
+     * instruction of the main thread. Nothing is armed while another hook such as a debugger is installed.
+     */
+    class FLuaAsyncHook
+    {
+    public:
+        enum ERequest : uint32
+        {
+            Sample = 1 << 0,
+            Timeout = 1 << 1,
+        };
+
+        explicit FLuaAsyncHook(lua_State* L);
+
+        /**
+         * Post requests and arm the hook, thread safe
+         */
+        void Request(uint32 Requests);
+
+        /**
+         * Withdraw requests not served yet, thread safe
+         */
+        FORCEINLINE void Cancel(uint32 Requests) { Pending.fetch_and(~Requests); }
+
+    private:
+        static void OnHook(lua_State* L, lua_Debug* ar);
+
+        lua_State* L;
+        std::atomic<uint32> Pending;
+    };
+}
@@ -0,0 +1,83 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#include "LuaBytecodeCache.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "UnLuaBase.h"
+
+namespace UnLua
+{
+    static int WriteBytecode(lua_State* L, const void* Data, size_t Size, void* Userdata)
+    {
+        static_cast<TArray<uint8>*>(Userdata)->Append(static_cast<const uint8*>(Data), Size);
+        return 0;
+    }
+
+    FLuaBytecodeCache::FLuaBytecodeCache(const FString& Directory, bool bStrip)
+        : Directory(Directory), bStrip(bStrip)
+    {
+        IFileManager::Get().MakeDirectory(*Directory, true);
+    }
+
+    FString FLuaBytecodeCache::GetCachePath(const TArray<uint8>& Source, const FString& Key) const
+    {
+        static const char* Version = PREPROCESSOR_TO_STRING(UNLUA_LUA_VERSION) " " LUA_RELEASE;
+        const uint8 Flags = bStrip ? 1 : 0;
+
+        FSHA1 Sha;
+        Sha.Update((const uint8*)Version, FCStringAnsi::Strlen(Version));
+        Sha.Update(&Flags, sizeof(Flags));
+        Sha.UpdateWithString(*Key, Key.Len());
+        Sha.Update(Source.GetData(), Source.Num());
+        Sha.Final();
+
+        FSHAHash Hash;
+        Sha.GetHash(Hash.Hash);
+        return FPaths::Combine(Directory, Hash.ToString() + TEXT(".luac"));
+    }
+
+    bool FLuaBytecodeCache::Load(lua_State* L, const FString& CachePath, const FString& ChunkName) const
+    {
+        TArray<uint8> Bytecode;
+        if (!FFileHelper::LoadFileToArray(Bytecode, *CachePath, FILEREAD_Silent))
+            return false;
+
+        const auto Code = luaL_loadbufferx(L, (const char*)Bytecode.GetData(), Bytecode.Num(), TCHAR_TO_UTF8(*ChunkName), "b");
+        if (Code == LUA_OK)
+            return true;
+
+        // 缓存损坏或由其他Lua版本生成，删掉后重新编译
+        UE_LOG(LogUnLua, Warning, TEXT("Discard invalid bytecode cache %s of %s: %s"), *CachePath, *ChunkName, UTF8_TO_TCHAR(lua_tostring(L, -1)));
+        lua_pop(L, 1);
+        IFileManager::Get().Delete(*CachePath, false, false, true);
+        return false;
+    }
+
+    void FLuaBytecodeCache::Save(lua_State* L, const FString& CachePath) const
+    {
+        TArray<uint8> Bytecode;
+        if (lua_dump(L, WriteBytecode, &Bytecode, bStrip) != 0)
+            return;
+
+        // 先写临时文件再改名，避免并发启动的进程读到写了一半的文件
+        const auto TempPath = FPaths::CreateTempFilename(*Directory, TEXT("luac"));
+        if (!FFileHelper::SaveArrayToFile(Bytecode, *TempPath))
+            return;
+
+        if (!IFileManager::Get().Move(*CachePath, *TempPath, true, true, false, true))
+            IFileManager::Get().Delete(*TempPath, false, false, true);
+    }
+}
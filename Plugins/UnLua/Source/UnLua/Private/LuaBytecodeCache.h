@@ -0,0 +1,53 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "lua.hpp"
+
+namespace UnLua
+{
+    /**
+     * On-disk cache of compiled Lua chunks
+     *
+     * Each chunk is stored as a lua_dump of its compiled function, in a file named after the hash of the Lua version,
+     * the key of the chunk and the source, so edited sources and other Lua builds never hit stale bytecode.
+     */
+    class FLuaBytecodeCache
+    {
+    public:
+        FLuaBytecodeCache(const FString& Directory, bool bStrip);
+
+        /**
+         * Get the cache file of a chunk
+         *
+         * @param Key - identifies the chunk, it shouldn't depend on the machine for caches staged with the build
+         */
+        FString GetCachePath(const TArray<uint8>& Source, const FString& Key) const;
+
+        /**
+         * Load the cached bytecode of a chunk and push the function on success
+         */
+        bool Load(lua_State* L, const FString& CachePath, const FString& ChunkName) const;
+
+        /**
+         * Dump the compiled function on the top of the stack into the cache
+         */
+        void Save(lua_State* L, const FString& CachePath) const;
+
+    private:
+        FString Directory;
+        bool bStrip;
+    };
+}
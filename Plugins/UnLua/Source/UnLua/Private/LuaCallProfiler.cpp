@@ -0,0 +1,93 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#include "LuaCallProfiler.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace UnLua
+{
+    bool FCallProfiler::bEnabled = false;
+    TMap<UPTRINT, TUniquePtr<FCallProfiler::FRecord>> FCallProfiler::Records;
+
+    void FCallProfiler::Start()
+    {
+        // 可能在被统计的调用中重新开始，记录仍被FScope引用，只清零不释放
+        for (const auto& Pair : Records)
+        {
+            FRecord& Record = *Pair.Value;
+            Record.Calls = 0;
+            Record.InclusiveCycles = 0;
+            Record.BodyCycles = 0;
+        }
+        bEnabled = true;
+    }
+
+    void FCallProfiler::Stop()
+    {
+        bEnabled = false;
+    }
+
+    FString FCallProfiler::Dump(const FString& FilePath)
+    {
+        TArray<const FRecord*> Sorted;
+        Sorted.Reserve(Records.Num());
+        for (const auto& Pair : Records)
+        {
+            if (Pair.Value->Calls > 0)
+                Sorted.Add(Pair.Value.Get());
+        }
+        if (Sorted.Num() == 0)
+            return FString();
+
+        Sorted.Sort([](const FRecord& A, const FRecord& B) { return A.InclusiveCycles > B.InclusiveCycles; });
+
+        const double MsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+        FString Csv = TEXT("Function,Direction,Calls,InclusiveMs,MarshalMs,BodyMs,AvgUs\n");
+        for (const auto Record : Sorted)
+        {
+            const double InclusiveMs = Record->InclusiveCycles * MsPerCycle;
+            const double BodyMs = Record->BodyCycles * MsPerCycle;
+            const double AvgUs = Record->Calls ? InclusiveMs * 1000.0 / Record->Calls : 0.0;
+            const TCHAR* Direction = Record->bToLua ? TEXT("UE->Lua") : TEXT("Lua->UE");
+            Csv += FString::Printf(TEXT("%s,%s,%llu,%.3f,%.3f,%.3f,%.3f\n"), *Record->Name, Direction, Record->Calls, InclusiveMs, InclusiveMs - BodyMs, BodyMs, AvgUs);
+            UE_LOG(LogUnLua, Log, TEXT("%-64s %-8s calls=%-8llu inclusive=%.3fms marshal=%.3fms body=%.3fms avg=%.3fus"),
+                   *Record->Name, Direction, Record->Calls, InclusiveMs, InclusiveMs - BodyMs, BodyMs, AvgUs);
+        }
+
+        FString Path = FilePath;
+        if (Path.IsEmpty())
+            Path = FPaths::ProfilingDir() / TEXT("UnLua") / FString::Printf(TEXT("Calls-%s.csv"), *FDateTime::Now().ToString());
+        if (!FFileHelper::SaveStringToFile(Csv, *Path))
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("failed to write lua call profile to %s"), *Path);
+            return FString();
+        }
+        return Path;
+    }
+
+    FCallProfiler::FRecord& FCallProfiler::FindOrAdd(const UFunction* Function, bool bToLua)
+    {
+        const UPTRINT Key = (UPTRINT)Function | (bToLua ? 1 : 0);
+        if (const auto Exists = Records.Find(Key))
+            return **Exists;
+
+        auto Record = MakeUnique<FRecord>();
+        Record->Name = FString::Printf(TEXT("%s.%s"), *Function->GetOuter()->GetName(), *Function->GetName());
+        Record->bToLua = bToLua;
+#if STATS
+        Record->StatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_UnLuaCalls>(Record->Name);
+#endif
+        return *Records.Add(Key, MoveTemp(Record));
+    }
+}
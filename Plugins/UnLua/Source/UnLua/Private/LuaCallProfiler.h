@@ -0,0 +1,115 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "UnLuaPrivate.h"
+
+namespace UnLua
+{
+    /**
+     * Counters of calls crossing the Lua/C++ boundary, collected per UFunction
+     */
+    class FCallProfiler
+    {
+    public:
+        struct FRecord
+        {
+            FString Name;
+            bool bToLua = false;
+            uint64 Calls = 0;
+            uint64 InclusiveCycles = 0;
+            uint64 BodyCycles = 0;
+#if STATS
+            TStatId StatId;
+#endif
+        };
+
+        /**
+         * Measure one call, the time outside of the body is accounted as marshalling
+         */
+        class FScope final
+        {
+        public:
+            FORCEINLINE FScope(const UFunction* Function, bool bToLua)
+                : Record(bEnabled ? &FindOrAdd(Function, bToLua) : nullptr)
+#if STATS
+                , CycleCounter(Record ? Record->StatId : TStatId())
+#endif
+            {
+                if (Record)
+                    StartCycles = FPlatformTime::Cycles64();
+            }
+
+            FORCEINLINE ~FScope()
+            {
+                if (!Record)
+                    return;
+                Record->Calls += Calls;
+                Record->InclusiveCycles += FPlatformTime::Cycles64() - StartCycles;
+                Record->BodyCycles += BodyCycles;
+            }
+
+            /**
+             * Set the number of calls the scope stands for, a batch call counts every dispatched object
+             */
+            FORCEINLINE void SetCalls(uint64 InCalls)
+            {
+                Calls = InCalls;
+            }
+
+            FORCEINLINE void BeginBody()
+            {
+                if (Record)
+                    BodyStartCycles = FPlatformTime::Cycles64();
+            }
+
+            FORCEINLINE void EndBody()
+            {
+                if (Record)
+                    BodyCycles += FPlatformTime::Cycles64() - BodyStartCycles;
+            }
+
+        private:
+            FRecord* Record;
+#if STATS
+            FScopeCycleCounter CycleCounter;
+#endif
+            uint64 StartCycles = 0;
+            uint64 BodyStartCycles = 0;
+            uint64 BodyCycles = 0;
+            uint64 Calls = 1;
+        };
+
+        static FORCEINLINE bool IsEnabled() { return bEnabled; }
+
+        static void Start();
+
+        static void Stop();
+
+        /**
+         * Log the records sorted by inclusive time and write them to a CSV file
+         *
+         * @return - the path of the CSV file, empty if nothing was recorded
+         */
+        static FString Dump(const FString& FilePath = FString());
+
+    private:
+        static FRecord& FindOrAdd(const UFunction* Function, bool bToLua);
+
+        static bool bEnabled;
+        static TMap<UPTRINT, TUniquePtr<FRecord>> Records;
+    };
+}
@@ -439,7 +439,7 @@ void* CacheScriptContainer(lua_State *L, void *Key, const FScriptContainerDesc &
 
     // return null if container is already cached, or create/cache/return a new ud
     void *Userdata = nullptr;
-    lua_getfield(L, LUA_REGISTRYINDEX, "ScriptContainerMap");
+    lua_rawgeti(L, LUA_REGISTRYINDEX, UnLua::FLuaEnv::FindEnvChecked(L).GetContainerRegistry()->GetMapRef());
     lua_pushlightuserdata(L, Key);
     int32 Type = lua_rawget(L, -2);             
     if (Type == LUA_TNIL)
@@ -474,7 +474,7 @@ void* CacheScriptContainer(lua_State *L, void *Key, const FScriptContainerDesc &
 
     // return null if container is already cached, or create/cache/return a new ud
     void *Userdata = nullptr;
-    lua_getfield(L, LUA_REGISTRYINDEX, "ScriptContainerMap");
+    lua_rawgeti(L, LUA_REGISTRYINDEX, UnLua::FLuaEnv::FindEnvChecked(L).GetContainerRegistry()->GetMapRef());
     lua_pushlightuserdata(L, Key);
     int32 Type = lua_rawget(L, -2);
     if (Type == LUA_TNIL || !Validator(lua_touserdata(L, -1)))
@@ -523,7 +523,7 @@ void RemoveCachedScriptContainer(lua_State *L, void *Key)
         return;
     }
 
-    lua_getfield(L, LUA_REGISTRYINDEX, "ScriptContainerMap");
+    lua_rawgeti(L, LUA_REGISTRYINDEX, UnLua::FLuaEnv::FindEnvChecked(L).GetContainerRegistry()->GetMapRef());
     lua_pushlightuserdata(L, Key);
     int32 Type = lua_rawget(L, -2);
     if (Type != LUA_TNIL)
@@ -589,7 +589,7 @@ static void PushEnumElement(lua_State *L, FNumericProperty *Property, void *Valu
  */
 static void PushFNameElement(lua_State *L, FNameProperty *Property, void *Value)
 {
-    lua_pushstring(L, TCHAR_TO_UTF8(*Property->GetPropertyValue(Value).ToString()));
+    UnLua::FLuaEnv::FindEnvChecked(L).GetNameCache()->Push(L, Property->GetPropertyValue(Value));
 }
 
 /**
@@ -710,7 +710,7 @@ static void PushPropertyArray(lua_State *L, T *Property, void *Value, void(*Push
         return;
     }
 
-    lua_getfield(L, LUA_REGISTRYINDEX, "ArrayMap");         // get weak table 'ArrayMap'
+    lua_rawgeti(L, LUA_REGISTRYINDEX, UnLua::FLuaEnv::FindEnvChecked(L).GetArrayMapRef());    // get weak table 'ArrayMap'
     lua_pushlightuserdata(L, Value);
     int32 Type = lua_rawget(L, -2);
     if (Type != LUA_TTABLE)
@@ -835,16 +835,7 @@ bool GetObjectMapping(lua_State *L, UObjectBaseUtility *Object)
         return false;
     }
 
-    lua_getfield(L, LUA_REGISTRYINDEX, "UnLua_ObjectMap");
-    lua_pushlightuserdata(L, Object);
-    int32 Type = lua_rawget(L, -2);
-    if (Type != LUA_TNIL)
-    {
-        lua_remove(L, -2);
-        return true;
-    }
-    lua_pop(L, 2);
-    return false;
+    return UnLua::FLuaEnv::FindEnvChecked(L).GetObjectRegistry()->PushExisting(L, (UObject*)Object);
 }
 
 /**
@@ -920,7 +911,10 @@ bool PushFunction(lua_State *L, UObjectBaseUtility *Object, int32 FunctionRef)
 bool CallFunction(lua_State *L, int32 NumArgs, int32 NumResults)
 {
     int32 ErrorReporterIdx = lua_gettop(L) - NumArgs - 1;
+    const auto Arena = UnLua::FLuaEnv::FindEnvChecked(L).GetParamBufferArena();
+    const auto ArenaMark = Arena->GetMark();
     int32 Code = lua_pcall(L, NumArgs, NumResults, -(NumArgs + 2));
+    Arena->Restore(ArenaMark);
     if (Code == LUA_OK)
     {
         lua_remove(L, ErrorReporterIdx);
@@ -940,8 +934,7 @@ static void PushField(lua_State *L, TSharedPtr<FFieldDesc> Field)
     check(Field && Field->IsValid());
     if (Field->IsProperty())
     {
-        TSharedPtr<FPropertyDesc> Property = Field->AsProperty();
-        Env.GetObjectRegistry()->Push(L, Property);
+        FPropertyAccessor::Push(L, Field->AsProperty());
     }
     else
     {
@@ -990,19 +983,9 @@ static void GetFieldInternal(lua_State* L)
             // check cached property from non-native class
             if (bCached && !Field->OuterClass->IsNative())
             {
-                auto Ptr = lua_touserdata(L, -1);
-                if (Ptr)
-                {
-                    auto Property = static_cast<TSharedPtr<UnLua::ITypeOps>*>(Ptr);
-                    if (Property && Property->IsValid())
-                    {
-                        auto PropertyDesc = static_cast<FPropertyDesc*>((*Property).Get());
-                        if (!PropertyDesc->IsValid())
-                        {
-                            bCached = false;
-                        }
-                    }
-                }
+                const auto Accessor = FPropertyAccessor::Get(L, -1);
+                if (Accessor && !Accessor->IsValid())
+                    bCached = false;
             }
             if (!bCached)
             {
@@ -1055,6 +1038,42 @@ FORCEINLINE static int32 GetField(lua_State* L)
     return 1;
 }
 
+bool PushInstanceMetatable(lua_State *L, int32 Index)
+{
+    if (!lua_getmetatable(L, Index))
+        return false;
+
+    // bound instance -> module -> class metatable, class metatables are their own metatables
+    for (int32 Depth = 0; Depth < 3; ++Depth)
+    {
+        lua_pushstring(L, "ClassDesc");
+        const int32 Type = lua_rawget(L, -2);
+        lua_pop(L, 1);
+        if (Type == LUA_TLIGHTUSERDATA)
+            return true;
+        if (!lua_getmetatable(L, -1))
+            break;
+        lua_remove(L, -2);
+    }
+    lua_pop(L, 1);
+    return false;
+}
+
+void PushMetatableField(lua_State *L, int32 MetatableIndex, int32 KeyIndex)
+{
+    MetatableIndex = lua_absindex(L, MetatableIndex);
+    KeyIndex = lua_absindex(L, KeyIndex);
+    lua_pushvalue(L, KeyIndex);
+    if (lua_rawget(L, MetatableIndex) != LUA_TNIL)
+        return;
+
+    lua_pop(L, 1);
+    lua_pushcfunction(L, GetField);
+    lua_pushvalue(L, MetatableIndex);
+    lua_pushvalue(L, KeyIndex);
+    lua_call(L, 2, 1);
+}
+
 /**
  * Debug only...
  */
@@ -1183,12 +1202,11 @@ int32 Class_Index(lua_State *L)
 {
     GetField(L);
 
-    auto Ptr = lua_touserdata(L, -1);
-    if (!Ptr)
+    const auto Accessor = FPropertyAccessor::Get(L, -1);
+    if (!Accessor)
         return 1;
 
-    auto Property = static_cast<TSharedPtr<UnLua::ITypeOps>*>(Ptr);
-    if (!Property->IsValid())
+    if (!Accessor->IsValid())
         return 0;
     
     auto Self = GetCppInstance(L, 1);
@@ -1196,12 +1214,12 @@ int32 Class_Index(lua_State *L)
         return 1;
 
     if (UnLua::LowLevel::IsReleasedPtr(Self))
-        return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to read property '%s' on released object"), *(*Property)->GetName())));
+        return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to read property '%s' on released object"), *Accessor->GetName())));
 
-    if (!UnLua::LowLevel::CheckPropertyOwner(L, (*Property).Get(), Self))
+    if (!Accessor->CheckOwner(L, Self))
         return 0;
 
-    (*Property)->ReadValue_InContainer(L, Self, false);
+    Accessor->Read(L, Self);
     lua_remove(L, -2);
     return 1;
 }
@@ -1213,22 +1231,21 @@ int32 Class_NewIndex(lua_State *L)
 {
     GetField(L);
 
-    auto Ptr = lua_touserdata(L, -1);
-    if (Ptr)
+    const auto Accessor = FPropertyAccessor::Get(L, -1);
+    if (Accessor)
     {
-        auto Property = static_cast<TSharedPtr<UnLua::ITypeOps>*>(Ptr);
-        if (Property->IsValid())
+        if (Accessor->IsValid())
         {
             void* Self = GetCppInstance(L, 1);
             if (Self)
             {
                 if (UnLua::LowLevel::IsReleasedPtr(Self))
-                    return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to write property '%s' on released object"), *(*Property)->GetName())));
+                    return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to write property '%s' on released object"), *Accessor->GetName())));
 
-                if (!UnLua::LowLevel::CheckPropertyOwner(L, (*Property).Get(), Self))
+                if (!Accessor->CheckOwner(L, Self))
                     return 0;
 
-                (*Property)->WriteValue_InContainer(L, Self, 3);
+                Accessor->Write(L, Self, 3);
             }
         }
     }
@@ -1280,7 +1297,7 @@ int32 Class_CallLatentFunction(lua_State *L)
         return 0;
     }
 
-    auto ThreadRef = Env.FindOrAddThread(L);
+    auto ThreadRef = Env.AddThread(L);
     if (ThreadRef == LUA_REFNIL)
     {
         UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("%s: Can't call latent action in main lua thread!"), ANSI_TO_TCHAR(__FUNCTION__));
@@ -1363,19 +1380,18 @@ int32 Class_Cast(lua_State* L)
 int32 ScriptStruct_Index(lua_State *L)
 {
     GetField(L);
-    if (lua_type(L, -1) != LUA_TUSERDATA)
+    const auto Accessor = FPropertyAccessor::Get(L, -1);
+    if (!Accessor)
         return 1;
 
-    const auto Registry = UnLua::FLuaEnv::FindEnvChecked(L).GetObjectRegistry();
-    const auto Property = Registry->Get<UnLua::ITypeOps>(L, -1);
-    if (!Property.IsValid())
+    if (!Accessor->IsValid())
         return 0;
 
     void* Self = GetCppInstanceFast(L, 1);
     if (!Self)
-        return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to read property '%s' on released struct"), *Property->GetName())));
+        return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to read property '%s' on released struct"), *Accessor->GetName())));
 
-    Property->ReadValue_InContainer(L, Self, false);
+    Accessor->Read(L, Self);
     lua_remove(L, -2);
     return 1;
 }
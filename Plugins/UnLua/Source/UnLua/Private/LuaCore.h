@@ -117,6 +117,16 @@ void CreateWeakValueTable(lua_State *L);
 int32 TraverseTable(lua_State *L, int32 Index, void *Userdata, bool (*TraverseWorker)(lua_State*, void*));
 bool PeekTableElement(lua_State *L, void *Userdata);
 
+/**
+ * Push the class metatable of a UObject/UScriptStruct instance, a Lua instance bound to a UObject or a class table
+ */
+bool PushInstanceMetatable(lua_State *L, int32 Index);
+
+/**
+ * Push a field (property accessor or closure) of a class metatable, it is resolved and cached on first access
+ */
+void PushMetatableField(lua_State *L, int32 MetatableIndex, int32 KeyIndex);
+
 /**
  * Functions to handle UClass
  */
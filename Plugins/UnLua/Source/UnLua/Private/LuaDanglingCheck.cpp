@@ -14,6 +14,7 @@
 
 #include "LuaDanglingCheck.h"
 #include "LowLevel.h"
+#include "LuaCore.h"
 #include "LuaEnv.h"
 #include "UnLuaDebugBase.h"
 
@@ -21,20 +22,27 @@ namespace UnLua
 {
     bool FDanglingCheck::Enabled;
 
-    FDanglingCheck::FGuard::FGuard(FDanglingCheck* Owner)
-        : Owner(Owner)
+    FDanglingCheck::FGuard::FGuard(FDanglingCheck* Owner, bool bCapture)
+        : Owner(Owner), ViewsBase(Owner->NumStructViews), bCapture(bCapture)
     {
-        Owner->GuardCount++;
+        if (bCapture)
+            Owner->GuardCount++;
     }
 
     FDanglingCheck::FGuard::~FGuard()
     {
+        if (Owner->NumStructViews > ViewsBase)
+            Owner->ReleaseStructViews(ViewsBase);
+
+        if (!bCapture)
+            return;
+
         Owner->GuardCount--;
 
         if (Owner->CapturedStructs.Num() > 0)
         {
             const auto L = Owner->Env->GetMainState();
-            lua_getfield(L, LUA_REGISTRYINDEX, "StructMap");
+            lua_rawgeti(L, LUA_REGISTRYINDEX, Owner->Env->GetStructMapRef());
             for (const auto& StructPtr : Owner->CapturedStructs)
             {
                 lua_pushlightuserdata(L, StructPtr);
@@ -65,7 +73,7 @@ namespace UnLua
         if (Owner->CapturedContainers.Num() > 0)
         {
             const auto L = Owner->Env->GetMainState();
-            lua_getfield(L, LUA_REGISTRYINDEX, "ScriptContainerMap");
+            lua_rawgeti(L, LUA_REGISTRYINDEX, Owner->Env->GetContainerRegistry()->GetMapRef());
             for (const auto& ContainerPtr : Owner->CapturedContainers)
             {
                 lua_pushlightuserdata(L, ContainerPtr);
@@ -94,15 +102,15 @@ namespace UnLua
     }
 
     FDanglingCheck::FDanglingCheck(FLuaEnv* Env)
-        : Env(Env), GuardCount(0)
+        : Env(Env), GuardCount(0), StructViewsRef(LUA_NOREF), NumStructViews(0)
     {
     }
 
-    TUniquePtr<FDanglingCheck::FGuard> FDanglingCheck::MakeGuard()
+    TUniquePtr<FDanglingCheck::FGuard> FDanglingCheck::MakeGuard(bool bTrackViews)
     {
-        if (!Enabled)
+        if (!Enabled && !bTrackViews)
             return TUniquePtr<FGuard>();
-        return MakeUnique<FGuard>(this);
+        return MakeUnique<FGuard>(this, Enabled);
     }
 
     void FDanglingCheck::CaptureStruct(lua_State* L, void* Value)
@@ -118,4 +126,46 @@ namespace UnLua
             return;
         CapturedContainers.Add(Value);
     }
+
+    void FDanglingCheck::PushStructView(lua_State* L, void* Value, const char* MetatableName)
+    {
+        NewUserdataWithTwoLvPtrTag(L, sizeof(void*), Value);
+        if (!TryToSetMetatable(L, MetatableName))
+        {
+            lua_pop(L, 1);
+            lua_pushnil(L);
+            return;
+        }
+
+        // anchor the view until the call returns, so it can still be invalidated
+        if (StructViewsRef == LUA_NOREF)
+        {
+            lua_newtable(L);
+            StructViewsRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        }
+        lua_rawgeti(L, LUA_REGISTRYINDEX, StructViewsRef);
+        lua_pushvalue(L, -2);
+        lua_rawseti(L, -2, ++NumStructViews);
+        lua_pop(L, 1);
+    }
+
+    void FDanglingCheck::ReleaseStructViews(int32 Base)
+    {
+        const auto L = Env->GetMainState();
+        lua_rawgeti(L, LUA_REGISTRYINDEX, StructViewsRef);
+        for (int32 Index = NumStructViews; Index > Base; --Index)
+        {
+            lua_rawgeti(L, -1, Index);
+            bool TwoLevelPtr;
+            void* Userdata = GetUserdataFast(L, -1, &TwoLevelPtr);
+            check(Userdata && TwoLevelPtr);
+            *(void**)Userdata = nullptr;
+            lua_pop(L, 1);
+
+            lua_pushnil(L);
+            lua_rawseti(L, -2, Index);
+        }
+        lua_pop(L, 1);
+        NumStructViews = Base;
+    }
 }
@@ -29,26 +29,42 @@ namespace UnLua
         class FGuard final
         {
         public:
-            explicit FGuard(FDanglingCheck* Owner);
+            FGuard(FDanglingCheck* Owner, bool bCapture);
 
             ~FGuard();
 
         private:
             FDanglingCheck* Owner;
+            int32 ViewsBase;
+            bool bCapture;
         };
 
         explicit FDanglingCheck(FLuaEnv* Env);
 
-        TUniquePtr<FGuard> MakeGuard();
+        /**
+         * Make a guard for a call into Lua
+         *
+         * @param bTrackViews - whether struct views pushed during the call have to be invalidated, even if the dangling check is disabled
+         */
+        TUniquePtr<FGuard> MakeGuard(bool bTrackViews = false);
 
         void CaptureStruct(lua_State* L, void* Value);
 
         void CaptureContainer(lua_State* L, void* Value);
 
+        /**
+         * Push a borrowed view of a struct in a parameter frame, it is invalidated when the innermost guard is released
+         */
+        void PushStructView(lua_State* L, void* Value, const char* MetatableName);
+
     private:
+        void ReleaseStructViews(int32 Base);
+
         FLuaEnv* Env;
         int32 GuardCount;
         TSet<void*> CapturedStructs;
         TSet<void*> CapturedContainers;
+        int32 StructViewsRef;
+        int32 NumStructViews;
     };
 }
@@ -15,6 +15,7 @@
 #include "LuaDeadLoopCheck.h"
 #include "HAL/RunnableThread.h"
 #include "UnLuaModule.h"
+#include "LuaEnv.h"
 
 namespace UnLua
 {
@@ -83,9 +84,9 @@ namespace UnLua
         TimeoutGuard.store(Guard);
     }
 
-    void FDeadLoopCheck::FRunner::GuardLeave()
+    bool FDeadLoopCheck::FRunner::GuardLeave()
     {
-        GuardCounter.Decrement();
+        return GuardCounter.Decrement() == 0;
     }
 
     FDeadLoopCheck::FGuard::FGuard(FDeadLoopCheck* Owner)
@@ -96,20 +97,13 @@ namespace UnLua
 
     FDeadLoopCheck::FGuard::~FGuard()
     {
-        Owner->Runner->GuardLeave();
+        // 超时请求还没被处理时Lua已经返回，撤回以免下次执行时误报
+        if (Owner->Runner->GuardLeave())
+            Owner->Env->GetAsyncHook()->Cancel(FLuaAsyncHook::Timeout);
     }
 
     void FDeadLoopCheck::FGuard::SetTimeout()
     {
-        const auto L = Owner->Env->GetMainState();
-        const auto Hook = lua_gethook(L);
-        if (Hook == nullptr)
-            lua_sethook(L, OnLuaLineEvent, LUA_MASKLINE, 0);
-    }
-
-    void FDeadLoopCheck::FGuard::OnLuaLineEvent(lua_State* L, lua_Debug* ar)
-    {
-        lua_sethook(L, nullptr, 0, 0);
-        luaL_error(L, "lua script exec timeout");
+        Owner->Env->GetAsyncHook()->Request(FLuaAsyncHook::Timeout);
     }
 }
@@ -38,8 +38,6 @@ namespace UnLua
             void SetTimeout();
 
         private:
-            static void OnLuaLineEvent(lua_State* L, lua_Debug* ar);
-
             FDeadLoopCheck* Owner;
         };
 
@@ -56,7 +54,10 @@ namespace UnLua
 
             void GuardEnter(FGuard* Guard);
 
-            void GuardLeave();
+            /**
+             * @return - true if the outermost guard left
+             */
+            bool GuardLeave();
 
         private:
             FThreadSafeBool bRunning;
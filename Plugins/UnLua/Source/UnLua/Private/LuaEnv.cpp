@@ -31,8 +31,6 @@
 #include "UnLuaLib.h"
 #include "UnLuaSettings.h"
 
-#include "LuaInternalHeaders.h"
-
 namespace UnLua
 {
 #if UE_VERSION_NEWER_THAN(5, 4, 0)
@@ -42,6 +40,14 @@ namespace UnLua
     constexpr EInternalObjectFlags AsyncObjectFlags = EInternalObjectFlags::AsyncLoading | EInternalObjectFlags::Async;
 #endif
 
+    // 蓝图原地重编译时UClass不变，编辑器中没有OnObjectsReplaced通知时不缓存绑定决策
+#define UNLUA_CACHE_BIND_DECISIONS (!WITH_EDITOR || !UE_VERSION_OLDER_THAN(5, 1, 0))
+
+    // linkage of latent actions: slot index in the low bits, slot serial in the high bits
+    static constexpr int32 ThreadSlotIndexBits = 20;
+    static constexpr int32 ThreadSlotIndexMask = (1 << ThreadSlotIndexBits) - 1;
+    static constexpr int32 MaxThreadSlotSerial = (1 << (31 - ThreadSlotIndexBits)) - 1;
+
     TMap<lua_State*, FLuaEnv*> FLuaEnv::AllEnvs;
     FLuaEnv::FOnCreated FLuaEnv::OnCreated;
     FLuaEnv::FOnDestroyed FLuaEnv::OnDestroyed;
@@ -83,6 +89,7 @@ namespace UnLua
     {
         const auto Settings = GetDefault<UUnLuaSettings>();
         ModuleLocator = Settings->ModuleLocatorClass.GetDefaultObject();
+        AsyncBindTimeBudget = Settings->AsyncBindTimeBudget / 1000.0;
         ensureMsgf(ModuleLocator, TEXT("Invalid lua module locator, lua binding will not work properly. please check unlua runtime settings."));
 
         RegisterDelegates();
@@ -98,10 +105,19 @@ namespace UnLua
         L = lua_newstate(GetLuaAllocator(), nullptr);
 #endif
 
+        // must be set before any thread created, threads copy the extra space from the main thread
+        static_assert(LUA_EXTRASPACE >= sizeof(FLuaEnv*), "LUA_EXTRASPACE is too small to hold FLuaEnv");
+        *(FLuaEnv**)lua_getextraspace(L) = this;
         AllEnvs.Add(L, this);
 
         luaL_openlibs(L);
 
+        // 协程从线程池中创建，等待过latent函数的协程执行完后回收复用
+        lua_getglobal(L, LUA_COLIBNAME);
+        lua_pushcfunction(L, CreateCoroutine);
+        lua_setfield(L, -2, "create");
+        lua_pop(L, 1);
+
         AddSearcher(LoadFromCustomLoader, 2);
         AddSearcher(LoadFromFileSystem, 3);
         AddSearcher(LoadFromBuiltinLibs, 4);
@@ -121,17 +137,32 @@ namespace UnLua
 
         DanglingCheck = new FDanglingCheck(this);
         DeadLoopCheck = new FDeadLoopCheck(this);
+        AsyncHook = new FLuaAsyncHook(L);
+        ParamBufferArena = new FParamBufferArena();
+        NameCache = new FNameCache(L);
+
+        if (Settings->bEnableBytecodeCache)
+        {
+            const auto CacheDir = Settings->BytecodeCacheDirectory.IsEmpty()
+                                      ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("UnLua/Bytecode"))
+                                      : FPaths::Combine(FPaths::ProjectDir(), Settings->BytecodeCacheDirectory);
+            BytecodeCache = new FLuaBytecodeCache(FPaths::ConvertRelativePathToFull(CacheDir), Settings->bStripBytecode);
+        }
 
         AutoObjectReference.SetName("UnLua_AutoReference");
         ManualObjectReference.SetName("UnLua_ManualReference");
 
-        lua_pushstring(L, "StructMap"); // create weak table 'StructMap'
-        LowLevel::CreateWeakValueTable(L);
-        lua_rawset(L, LUA_REGISTRYINDEX);
+        lua_newtable(L);
+        ThreadsRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        LowLevel::CreateWeakKeyTable(L);
+        OwnedThreadsRef = luaL_ref(L, LUA_REGISTRYINDEX);
 
-        lua_pushstring(L, "ArrayMap"); // create weak table 'ArrayMap'
-        LowLevel::CreateWeakValueTable(L);
-        lua_rawset(L, LUA_REGISTRYINDEX);
+        LowLevel::CreateWeakValueTable(L); // create weak table 'StructMap'
+        StructMapRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        LowLevel::CreateWeakValueTable(L); // create weak table 'ArrayMap'
+        ArrayMapRef = luaL_ref(L, LUA_REGISTRYINDEX);
 
         if (FUnLuaDelegates::ConfigureLuaGC.IsBound())
         {
@@ -193,6 +224,10 @@ namespace UnLua
         delete PropertyRegistry;
         delete DanglingCheck;
         delete DeadLoopCheck;
+        delete AsyncHook;
+        delete ParamBufferArena;
+        delete NameCache;
+        delete BytecodeCache;
 
         if (!IsEngineExitRequested() && Manager)
         {
@@ -214,20 +249,6 @@ namespace UnLua
         return AllEnvs;
     }
 
-    FLuaEnv* FLuaEnv::FindEnv(const lua_State* L)
-    {
-        if (!L)
-            return nullptr;
-
-        const auto MainThread = G(L)->mainthread;
-        return AllEnvs.FindRef(MainThread);
-    }
-
-    FLuaEnv& FLuaEnv::FindEnvChecked(const lua_State* L)
-    {
-        return *AllEnvs.FindChecked(G(L)->mainthread);
-    }
-
     void FLuaEnv::Start(const TMap<FString, UObject*>& Args)
     {
         const auto& Setting = *GetDefault<UUnLuaSettings>();
@@ -271,6 +292,11 @@ namespace UnLua
 
     void FLuaEnv::NotifyUObjectDeleted(const UObjectBase* ObjectBase, int32 Index)
     {
+        // 绝大多数被销毁的对象从未进入过Lua，一次位测试即可跳过
+        if (!KnownObjects.IsValidIndex(Index) || !KnownObjects[Index])
+            return;
+        KnownObjects[Index] = false;
+
         UObject* Object = (UObject*)ObjectBase;
         PropertyRegistry->NotifyUObjectDeleted(Object);
         FunctionRegistry->NotifyUObjectDeleted(Object);
@@ -279,6 +305,7 @@ namespace UnLua
         ObjectRegistry->NotifyUObjectDeleted(Object);
         ClassRegistry->NotifyUObjectDeleted(Object);
         EnumRegistry->NotifyUObjectDeleted(Object);
+        BindDecisions.Remove((UClass*)Object);
 
         if (CandidateInputComponents.Num() <= 0)
             return;
@@ -308,6 +335,7 @@ namespace UnLua
             return false;
 
         CandidateInputComponents.AddUnique((UInputComponent*)Object);
+        AddKnownObject(Object);
         if (OnWorldTickStartHandle.IsValid())
             FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
         OnWorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddRaw(this, &FLuaEnv::OnWorldTickStart);
@@ -340,6 +368,14 @@ namespace UnLua
         FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
     }
 
+#if WITH_EDITOR && !UE_VERSION_OLDER_THAN(5, 1, 0)
+    void FLuaEnv::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+    {
+        // 蓝图重编译可能改变类是否实现UnLuaInterface以及模块名
+        BindDecisions.Empty();
+    }
+#endif
+
     bool FLuaEnv::TryBind(UObject* Object)
     {
         const auto Class = Object->IsA<UClass>() ? static_cast<UClass*>(Object) : Object->GetClass();
@@ -349,22 +385,25 @@ namespace UnLua
             return false;
         }
 
-        static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
-        const bool bImplUnluaInterface = Class->ImplementsInterface(InterfaceClass);
-
         if (IsInAsyncLoadingThread())
         {
+            static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
+            const bool bImplUnluaInterface = Class->ImplementsInterface(InterfaceClass);
+
             // avoid adding too many objects, affecting performance.
-            if (bImplUnluaInterface || (!bImplUnluaInterface && GLuaDynamicBinding.IsValid(Class)))
+            if (bImplUnluaInterface || GLuaDynamicBinding.IsValid(Class))
             {
                 // all bind operation should be in game thread, include dynamic bind
-                FScopeLock Lock(&CandidatesLock);
-                Candidates.AddUnique(Object);
-                return false;
+                CandidateQueue.Enqueue(Object);
             }
+            return false;
         }
 
-        if (!bImplUnluaInterface)
+        const auto Decision = GetBindDecision(Class, Object);
+        if (!Decision)
+            return false;
+
+        if (!Decision->bImplUnluaInterface)
         {
             // dynamic binding
             if (!GLuaDynamicBinding.IsValid(Class))
@@ -373,15 +412,11 @@ namespace UnLua
             return GetManager()->Bind(Object, *GLuaDynamicBinding.ModuleName, GLuaDynamicBinding.InitializerTableRef);
         }
 
-        if (Class->GetName().Contains(TEXT("SKEL_")))
+        if (Decision->ModuleName.IsEmpty())
             return false;
 
-        if (!ensureMsgf(ModuleLocator, TEXT("Invalid lua module locator, lua binding will not work properly. please check unlua runtime settings.")))
-            return false;
-
-        const auto ModuleName = ModuleLocator->Locate(Object);
-        if (ModuleName.IsEmpty())
-            return false;
+        // 绑定过程中可能创建新对象并改写决策缓存，这里持有一份拷贝
+        const FString ModuleName = Decision->ModuleName;
 
 #if !UE_BUILD_SHIPPING
         if (GLuaDynamicBinding.IsValid(Class) && GLuaDynamicBinding.ModuleName != ModuleName)
@@ -393,6 +428,41 @@ namespace UnLua
         return GetManager()->Bind(Object, *ModuleName, GLuaDynamicBinding.InitializerTableRef);
     }
 
+    const FLuaEnv::FBindDecision* FLuaEnv::GetBindDecision(UClass* Class, UObject* Object)
+    {
+#if UNLUA_CACHE_BIND_DECISIONS
+        if (const auto Exists = BindDecisions.Find(Class))
+            return Exists;
+#endif
+
+        static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
+
+        FBindDecision Decision;
+        Decision.bImplUnluaInterface = Class->ImplementsInterface(InterfaceClass);
+        if (Decision.bImplUnluaInterface && !Class->GetName().Contains(TEXT("SKEL_")))
+        {
+            if (!ensureMsgf(ModuleLocator, TEXT("Invalid lua module locator, lua binding will not work properly. please check unlua runtime settings.")))
+                return nullptr;
+
+            Decision.ModuleName = ModuleLocator->Locate(Object);
+            if (Decision.ModuleName.IsEmpty())
+            {
+                // CDO还没有初始化完成时无法确定模块名，不缓存
+                const UObject* CDO = Class->GetDefaultObject(false);
+                if (!CDO || CDO->HasAnyFlags(RF_NeedInitialization))
+                    return nullptr;
+            }
+        }
+
+#if UNLUA_CACHE_BIND_DECISIONS
+        AddKnownObject(Class);
+        return &BindDecisions.Add(Class, MoveTemp(Decision));
+#else
+        UncachedDecision = MoveTemp(Decision);
+        return &UncachedDecision;
+#endif
+    }
+
     bool FLuaEnv::DoString(const FString& Chunk, const FString& ChunkName)
     {
         const FTCHARToUTF8 ChunkUTF8(*Chunk);
@@ -407,7 +477,9 @@ namespace UnLua
             return false;
         }
 
+        const auto ArenaMark = ParamBufferArena->GetMark();
         const auto Result = lua_pcall(L, 0, LUA_MULTRET, MsgHandlerIdx);
+        ParamBufferArena->Restore(ArenaMark);
         if (Result == LUA_OK)
         {
             lua_remove(L, MsgHandlerIdx);
@@ -446,6 +518,23 @@ namespace UnLua
         return true;
     }
 
+    bool FLuaEnv::LoadModule(lua_State* InL, const TArray<uint8>& Chunk, const FString& ChunkName, const FString* CacheKey)
+    {
+        // 已经是二进制chunk的不再缓存
+        if (!BytecodeCache || (Chunk.Num() > 0 && Chunk[0] == LUA_SIGNATURE[0]))
+            return LoadString(InL, Chunk, ChunkName);
+
+        const auto CachePath = BytecodeCache->GetCachePath(Chunk, CacheKey ? *CacheKey : ChunkName);
+        if (BytecodeCache->Load(InL, CachePath, ChunkName))
+            return true;
+
+        if (!LoadString(InL, Chunk, ChunkName))
+            return false;
+
+        BytecodeCache->Save(InL, CachePath);
+        return true;
+    }
+
     void FLuaEnv::GC()
     {
         lua_gc(L, LUA_GCCOLLECT, 0);
@@ -454,30 +543,41 @@ namespace UnLua
 
     void FLuaEnv::HotReload()
     {
+        FLuaModuleResolver::InvalidateAll();
         DoString("UnLua.HotReload()");
     }
 
-    int32 FLuaEnv::FindThread(const lua_State* Thread)
+    void FLuaEnv::ResumeThread(int32 Linkage)
     {
-        int32* ThreadRefPtr = ThreadToRef.Find(Thread);
-        return ThreadRefPtr ? *ThreadRefPtr : LUA_REFNIL;
-    }
+        const int32 Index = Linkage & ThreadSlotIndexMask;
+        if (!ThreadSlots.IsValidIndex(Index) || ThreadSlots[Index].Serial != Linkage >> ThreadSlotIndexBits)
+            return;
 
-    void FLuaEnv::ResumeThread(int32 ThreadRef)
-    {
-        lua_State** ThreadPtr = RefToThread.Find(ThreadRef);
-        if (!ThreadPtr)
+        lua_State* Thread = ThreadSlots[Index].Thread;
+        if (!Thread || lua_status(Thread) != LUA_YIELD)
+        {
+            ReleaseThreadSlot(L, Index);
             return;
+        }
+
+        // 恢复前先释放槽位，以便线程再次调用latent函数时重新登记；恢复期间由主线程栈锚定
+        lua_pushthread(Thread);
+        lua_xmove(Thread, L, 1);
+        ReleaseThreadSlot(L, Index);
 
-        lua_State* Thread = *ThreadPtr;
+        const auto ArenaMark = ParamBufferArena->GetMark();
 #if 504 == LUA_VERSION_NUM
         int NResults = 0;
         int32 Status = lua_resume(Thread, L, 0, &NResults);
 #else
         int32 Status = lua_resume(Thread, L, 0);
 #endif
+        ParamBufferArena->Restore(ArenaMark);
         if (Status == LUA_YIELD)
+        {
+            lua_pop(L, 1);
             return;
+        }
 
         if (Status != LUA_OK)
         {
@@ -485,9 +585,8 @@ namespace UnLua
             UE_LOG(LogUnLua, Error, TEXT("%s"), UTF8_TO_TCHAR(ErrMsg));
         }
 
-        ThreadToRef.Remove(Thread);
-        RefToThread.Remove(ThreadRef);
-        luaL_unref(L, LUA_REGISTRYINDEX, ThreadRef); // remove the reference if the coroutine finishes its execution
+        RecycleThread(L, Thread);
+        lua_pop(L, 1);
     }
 
     UUnLuaManager* FLuaEnv::GetManager()
@@ -501,28 +600,174 @@ namespace UnLua
         return Manager;
     }
 
-    void FLuaEnv::AddThread(lua_State* Thread, int32 ThreadRef)
+    int32 FLuaEnv::AddThread(lua_State* Thread)
     {
-        ThreadToRef.Add(Thread, ThreadRef);
-        RefToThread.Add(ThreadRef, Thread);
+        if (lua_pushthread(Thread) == 1)
+        {
+            lua_pop(Thread, 1);
+            return LUA_REFNIL;
+        }
+
+        // 等待中的线程以自身为键锚定在ThreadsRef表中，值为槽位索引+1
+        lua_rawgeti(Thread, LUA_REGISTRYINDEX, ThreadsRef);
+        lua_pushvalue(Thread, -2);
+        if (lua_rawget(Thread, -2) == LUA_TNUMBER)
+        {
+            // 同一线程再次等待时复用槽位，递增序列号使之前的linkage失效
+            const int32 Index = (int32)lua_tointeger(Thread, -1) - 1;
+            lua_pop(Thread, 3);
+            FThreadSlot& Slot = ThreadSlots[Index];
+            Slot.Serial = Slot.Serial == MaxThreadSlotSerial ? 1 : Slot.Serial + 1;
+            return Index | (Slot.Serial << ThreadSlotIndexBits);
+        }
+        lua_pop(Thread, 1);
+
+        int32 Index;
+        if (FreeThreadSlots.Num() > 0)
+        {
+            Index = FreeThreadSlots.Pop(false);
+        }
+        else
+        {
+            if (ThreadSlots.Num() > ThreadSlotIndexMask)
+            {
+                lua_pop(Thread, 2);
+                UE_LOG(LogUnLua, Error, TEXT("too many threads waiting on latent actions"));
+                return LUA_REFNIL;
+            }
+            Index = ThreadSlots.AddDefaulted();
+        }
+
+        lua_insert(Thread, -2);
+        lua_pushinteger(Thread, Index + 1);
+        lua_rawset(Thread, -3);
+        lua_pop(Thread, 1);
+
+        FThreadSlot& Slot = ThreadSlots[Index];
+        Slot.Thread = Thread;
+        return Index | (Slot.Serial << ThreadSlotIndexBits);
+    }
+
+    void FLuaEnv::ReleaseThreadSlot(lua_State* InL, int32 Index)
+    {
+        FThreadSlot& Slot = ThreadSlots[Index];
+        if (!Slot.Thread)
+            return;
+
+        lua_rawgeti(InL, LUA_REGISTRYINDEX, ThreadsRef);
+        lua_pushthread(Slot.Thread);
+        lua_xmove(Slot.Thread, InL, 1);
+        lua_pushnil(InL);
+        lua_rawset(InL, -3);
+        lua_pop(InL, 1);
+
+        Slot.Thread = nullptr;
+        Slot.Serial = Slot.Serial == MaxThreadSlotSerial ? 1 : Slot.Serial + 1;
+        FreeThreadSlots.Add(Index);
+    }
+
+    lua_State* FLuaEnv::NewThread(lua_State* InL)
+    {
+        lua_State* Thread;
+        if (ThreadPool.Num() > 0)
+        {
+            // 池中的线程以自身为键锚定在ThreadsRef表中，取出后由调用者持有
+            Thread = ThreadPool.Pop(false);
+            lua_rawgeti(InL, LUA_REGISTRYINDEX, ThreadsRef);
+            lua_pushthread(Thread);
+            lua_xmove(Thread, InL, 1);
+            lua_pushvalue(InL, -1);
+            lua_pushnil(InL);
+            lua_rawset(InL, -4);
+            lua_remove(InL, -2);
+        }
+        else
+        {
+            Thread = lua_newthread(InL);
+        }
+
+        // 弱表只标记由UnLua创建的线程，执行完后可以回收到池中
+        lua_rawgeti(InL, LUA_REGISTRYINDEX, OwnedThreadsRef);
+        lua_pushvalue(InL, -2);
+        lua_pushboolean(InL, true);
+        lua_rawset(InL, -3);
+        lua_pop(InL, 1);
+        return Thread;
+    }
+
+    /**
+     * coroutine.create backed by the thread pool. A coroutine which finishes when a latent action resumes it is
+     * recycled, its handle must not be used any more
+     */
+    int FLuaEnv::CreateCoroutine(lua_State* L)
+    {
+        luaL_checktype(L, 1, LUA_TFUNCTION);
+        auto& Env = FLuaEnv::FindEnvChecked(L);
+        lua_State* Thread = Env.NewThread(L);
+        lua_pushvalue(L, 1);
+        lua_xmove(L, Thread, 1);
+        return 1;
     }
 
-    int32 FLuaEnv::FindOrAddThread(lua_State* Thread)
+    void FLuaEnv::StartCoroutine(lua_State* InL, int32 NumArgs)
     {
-        int32 ThreadRef = FindThread(Thread);
-        if (ThreadRef == LUA_REFNIL)
+        lua_State* Thread = NewThread(InL);
+        lua_insert(InL, -(NumArgs + 2));
+        lua_xmove(InL, Thread, NumArgs + 1);
+
+        const auto ArenaMark = ParamBufferArena->GetMark();
+#if 504 == LUA_VERSION_NUM
+        int NResults = 0;
+        int32 Status = lua_resume(Thread, InL, NumArgs, &NResults);
+#else
+        int32 Status = lua_resume(Thread, InL, NumArgs);
+#endif
+        ParamBufferArena->Restore(ArenaMark);
+        if (Status != LUA_YIELD)
         {
-            int32 Value = lua_pushthread(Thread);
-            if (Value == 1)
+            if (Status != LUA_OK)
             {
-                lua_pop(Thread, 1);
-                return LUA_REFNIL;
+                const auto ErrMsg = lua_tostring(Thread, -1);
+                UE_LOG(LogUnLua, Error, TEXT("%s"), UTF8_TO_TCHAR(ErrMsg));
             }
 
-            ThreadRef = luaL_ref(Thread, LUA_REGISTRYINDEX);
-            AddThread(Thread, ThreadRef);
+            RecycleThread(InL, Thread);
+        }
+        lua_pop(InL, 1);
+    }
+
+    void FLuaEnv::RecycleThread(lua_State* InL, lua_State* Thread)
+    {
+#if 504 == LUA_VERSION_NUM
+        static constexpr int32 MaxPooledThreads = 64;
+        if (ThreadPool.Num() >= MaxPooledThreads)
+            return;
+
+        lua_rawgeti(InL, LUA_REGISTRYINDEX, OwnedThreadsRef);
+        lua_pushthread(Thread);
+        lua_xmove(Thread, InL, 1);
+        lua_pushvalue(InL, -1);
+        const bool bOwned = lua_rawget(InL, -3) != LUA_TNIL;
+        lua_pop(InL, 1);
+        if (!bOwned)
+        {
+            lua_pop(InL, 2);
+            return;
         }
-        return ThreadRef;
+
+#if LUA_VERSION_RELEASE_NUM >= 50406
+        lua_closethread(Thread, InL);
+#else
+        lua_resetthread(Thread);
+#endif
+        ThreadPool.Add(Thread);
+
+        lua_rawgeti(InL, LUA_REGISTRYINDEX, ThreadsRef);
+        lua_insert(InL, -2);
+        lua_pushboolean(InL, true);
+        lua_rawset(InL, -3);
+        lua_pop(InL, 2);
+#endif
     }
 
     lua_Alloc FLuaEnv::GetLuaAllocator() const
@@ -572,7 +817,7 @@ namespace UnLua
             FString ChunkName(TEXT("chunk"));
             if (FUnLuaDelegates::CustomLoadLuaFile.Execute(Env, FileName, Data, ChunkName))
             {
-                if (Env.LoadString(L, Data, ChunkName))
+                if (Env.LoadModule(L, Data, ChunkName))
                     return 1;
 
                 return luaL_error(L, "file loading from custom loader error");
@@ -592,7 +837,7 @@ namespace UnLua
             if (!Loader.Execute(Env, FileName, Data, ChunkName))
                 continue;
 
-            if (Env.LoadString(L, Data, ChunkName))
+            if (Env.LoadModule(L, Data, ChunkName))
                 break;
 
             return luaL_error(L, "file loading from custom loader error");
@@ -607,45 +852,51 @@ namespace UnLua
         FileName.ReplaceInline(TEXT("."), TEXT("/"));
 
         auto& Env = *(FLuaEnv*)lua_touserdata(L, lua_upvalueindex(1));
-        TArray<uint8> Data;
-        FString FullPath;
-
-        auto LoadIt = [&]
-        {
-            if (Env.LoadString(L, Data, FullPath))
-                return 1;
-            const auto Msg = FString::Printf(TEXT("file loading from file system error.\nfull path:%s"), *FullPath);
-            return luaL_error(L, TCHAR_TO_UTF8(*Msg));
-        };
-
         const auto PackagePath = UnLuaLib::GetPackagePath(L);
         if (PackagePath.IsEmpty())
             return 0;
 
-        TArray<FString> Patterns;
-        if (PackagePath.ParseIntoArray(Patterns, TEXT(";"), false) == 0)
+        FString FullPath;
+        if (!Env.ModuleResolver.Resolve(PackagePath, FileName, FullPath))
             return 0;
 
-        // 优先加载下载目录下的单文件
-        for (auto& Pattern : Patterns)
+        TArray<uint8> Data;
+        if (!FFileHelper::LoadFileToArray(Data, *FullPath, FILEREAD_Silent))
         {
-            Pattern.ReplaceInline(TEXT("?"), *FileName);
-            const auto PathWithPersistentDir = FPaths::Combine(FPaths::ProjectPersistentDownloadDir(), Pattern);
-            FullPath = FPaths::ConvertRelativePathToFull(PathWithPersistentDir);
-            if (FFileHelper::LoadFileToArray(Data, *FullPath, FILEREAD_Silent))
-                return LoadIt();
+            // 文件在索引之后被删除，重新查找一次
+            Env.ModuleResolver.Forget(FileName, FullPath);
+            if (!Env.ModuleResolver.Resolve(PackagePath, FileName, FullPath))
+                return 0;
+            if (!FFileHelper::LoadFileToArray(Data, *FullPath, FILEREAD_Silent))
+                return 0;
         }
 
-        // 其次是打包目录下的文件
-        for (auto& Pattern : Patterns)
+        if (!Env.BytecodeCache)
+        {
+            if (Env.LoadModule(L, Data, FullPath))
+                return 1;
+        }
+        else
         {
-            const auto PathWithProjectDir = FPaths::Combine(FPaths::ProjectDir(), Pattern);
-            FullPath = FPaths::ConvertRelativePathToFull(PathWithProjectDir);
-            if (FFileHelper::LoadFileToArray(Data, *FullPath, FILEREAD_Silent))
-                return LoadIt();
+            // 缓存以相对于下载目录或项目目录的路径为键，不依赖项目所在的绝对路径，可以随包发布
+            FString CacheKey = FullPath;
+            const FString BaseDirs[] = {FPaths::ProjectPersistentDownloadDir(), FPaths::ProjectDir()};
+            for (const auto& BaseDir : BaseDirs)
+            {
+                const auto FullBaseDir = FPaths::ConvertRelativePathToFull(BaseDir) / TEXT("");
+                if (!CacheKey.StartsWith(FullBaseDir))
+                    continue;
+
+                CacheKey = CacheKey.Mid(FullBaseDir.Len());
+                break;
+            }
+
+            if (Env.LoadModule(L, Data, FullPath, &CacheKey))
+                return 1;
         }
 
-        return 0;
+        const auto Msg = FString::Printf(TEXT("file loading from file system error.\nfull path:%s"), *FullPath);
+        return luaL_error(L, TCHAR_TO_UTF8(*Msg));
     }
 
     void FLuaEnv::AddSearcher(lua_CFunction Searcher, int Index) const
@@ -675,54 +926,54 @@ namespace UnLua
 
     void FLuaEnv::OnAsyncLoadingFlushUpdate()
     {
-        TArray<FWeakObjectPtr> CandidatesTemp;
-        TArray<int> CandidatesRemovedIndexes;
+        FWeakObjectPtr Candidate;
+        while (CandidateQueue.Dequeue(Candidate))
+            PendingCandidates.Add(Candidate);
 
-        TArray<UObject*> LocalCandidates;
-        {
-            {
-                FScopeLock Lock(&CandidatesLock);
-                CandidatesTemp.Append(Candidates);
-            }
+        if (PendingCandidates.Num() == 0)
+            return;
 
+        // 绑定时可能再次触发FlushAsyncLoading而重入，先把待处理列表移出来
+        TArray<FWeakObjectPtr> LocalCandidates = MoveTemp(PendingCandidates);
+        PendingCandidates.Reset();
 
-            for (int32 i = CandidatesTemp.Num() - 1; i >= 0; --i)
+        const double EndTime = AsyncBindTimeBudget > 0 ? FPlatformTime::Seconds() + AsyncBindTimeBudget : 0;
+        int32 NumKept = 0;
+        int32 Index = 0;
+        for (; Index < LocalCandidates.Num(); ++Index)
+        {
+            UObject* Object = LocalCandidates[Index].Get();
+            if (!Object)
             {
-                FWeakObjectPtr ObjectPtr = CandidatesTemp[i];
-                if (!ObjectPtr.IsValid())
-                {
-                    // discard invalid objects
-                    CandidatesRemovedIndexes.Add(i);
-                    continue;
-                }
-
-                UObject* Object = ObjectPtr.Get();
-                if (Object->HasAnyFlags(RF_NeedPostLoad)
-                    || Object->HasAnyInternalFlags(AsyncObjectFlags)
-                    || Object->GetClass()->HasAnyInternalFlags(AsyncObjectFlags))
-                {
-                    // delay bind on next update 
-                    continue;
-                }
-
-                LocalCandidates.Add(Object);
-                CandidatesRemovedIndexes.Add(i);
+                // discard invalid objects
+                continue;
             }
-        }
 
-        {
-            FScopeLock Lock(&CandidatesLock);
-            for (int32 j = 0; j < CandidatesRemovedIndexes.Num(); ++j)
+            if (Object->HasAnyFlags(RF_NeedPostLoad)
+                || Object->HasAnyInternalFlags(AsyncObjectFlags)
+                || Object->GetClass()->HasAnyInternalFlags(AsyncObjectFlags))
             {
-                Candidates.RemoveAt(CandidatesRemovedIndexes[j]);
+                // delay bind on next update
+                LocalCandidates[NumKept++] = LocalCandidates[Index];
+                continue;
             }
-        }
 
-        for (int32 i = 0; i < LocalCandidates.Num(); ++i)
-        {
-            UObject* Object = LocalCandidates[i];
+            // 等待期间可能已被按需绑定，再次绑定会重复调用Initialize
+            if (ObjectRegistry->IsBound(Object))
+                continue;
+
+            if (EndTime > 0 && FPlatformTime::Seconds() > EndTime)
+                break;
+
             TryBind(Object);
         }
+
+        // out of budget, keep the rest for next update
+        for (; Index < LocalCandidates.Num(); ++Index)
+            LocalCandidates[NumKept++] = LocalCandidates[Index];
+
+        LocalCandidates.SetNum(NumKept);
+        PendingCandidates.Insert(MoveTemp(LocalCandidates), 0);
     }
 
     FORCEINLINE void FLuaEnv::RegisterDelegates()
@@ -730,11 +981,17 @@ namespace UnLua
         OnAsyncLoadingFlushUpdateHandle = FCoreDelegates::OnAsyncLoadingFlushUpdate.AddRaw(this, &FLuaEnv::OnAsyncLoadingFlushUpdate);
         GUObjectArray.AddUObjectDeleteListener(this);
         bObjectArrayListenerRegistered = true;
+#if WITH_EDITOR && !UE_VERSION_OLDER_THAN(5, 1, 0)
+        FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FLuaEnv::OnObjectsReplaced);
+#endif
     }
 
     FORCEINLINE void FLuaEnv::UnRegisterDelegates()
     {
         FCoreDelegates::OnAsyncLoadingFlushUpdate.Remove(OnAsyncLoadingFlushUpdateHandle);
+#if WITH_EDITOR && !UE_VERSION_OLDER_THAN(5, 1, 0)
+        FCoreUObjectDelegates::OnObjectsReplaced.RemoveAll(this);
+#endif
         if (!bObjectArrayListenerRegistered)
             return;
         GUObjectArray.RemoveUObjectDeleteListener(this);
@@ -0,0 +1,142 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#include "LuaModuleResolver.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+namespace UnLua
+{
+    int32 FLuaModuleResolver::Generation = 0;
+
+    bool FLuaModuleResolver::Resolve(const FString& PackagePath, const FString& ModuleName, FString& OutFullPath)
+    {
+        if (CachedGeneration != Generation || !CachedPackagePath.Equals(PackagePath, ESearchCase::CaseSensitive))
+            Reset(PackagePath);
+
+        // 下载目录随时可能有新文件，每次都查询文件系统，不参与索引和缓存
+        for (const auto& Pattern : Patterns)
+        {
+            if (!Pattern.bDownload)
+                break;
+
+            const auto FullPath = FPaths::ConvertRelativePathToFull(Pattern.Path.Replace(TEXT("?"), *ModuleName));
+            if (!IFileManager::Get().FileExists(*FullPath))
+                continue;
+
+            OutFullPath = FullPath;
+            return true;
+        }
+
+        if (const auto Exists = Resolved.Find(ModuleName))
+        {
+            OutFullPath = *Exists;
+            return true;
+        }
+
+        if (Missing.Contains(ModuleName))
+            return false;
+
+        for (const auto& Pattern : Patterns)
+        {
+            if (Pattern.bDownload)
+                continue;
+
+            const auto FullPath = FPaths::ConvertRelativePathToFull(Pattern.Path.Replace(TEXT("?"), *ModuleName));
+            const bool bExists = Pattern.bIndexed ? Files.Contains(FullPath) : IFileManager::Get().FileExists(*FullPath);
+            if (!bExists)
+                continue;
+
+            Resolved.Add(ModuleName, FullPath);
+            OutFullPath = FullPath;
+            return true;
+        }
+
+        Missing.Add(ModuleName);
+        return false;
+    }
+
+    void FLuaModuleResolver::Forget(const FString& ModuleName, const FString& FullPath)
+    {
+        Resolved.Remove(ModuleName);
+        Files.Remove(FullPath);
+    }
+
+    void FLuaModuleResolver::InvalidateAll()
+    {
+        ++Generation;
+    }
+
+    void FLuaModuleResolver::Reset(const FString& PackagePath)
+    {
+        CachedGeneration = Generation;
+        CachedPackagePath = PackagePath;
+        Patterns.Reset();
+        Files.Reset();
+        Resolved.Reset();
+        Missing.Reset();
+
+        TArray<FString> Parts;
+        PackagePath.ParseIntoArray(Parts, TEXT(";"), true);
+
+        // 优先查找下载目录，其次是打包目录
+        for (const auto& Part : Parts)
+        {
+            auto& Pattern = Patterns.AddDefaulted_GetRef();
+            Pattern.Path = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectPersistentDownloadDir(), Part));
+            Pattern.bIndexed = false;
+            Pattern.bDownload = true;
+        }
+
+        const auto FullProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+        TSet<FString> IndexedDirectories;
+        for (const auto& Part : Parts)
+        {
+            auto& Pattern = Patterns.AddDefaulted_GetRef();
+            Pattern.Path = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectDir(), Part));
+            Pattern.bIndexed = false;
+            Pattern.bDownload = false;
+
+            int32 Index;
+            if (!Pattern.Path.FindChar(TEXT('?'), Index))
+                continue;
+
+            // 以'?'之前的目录为根建立索引，根目录不在项目目录之下时文件可能过多，直接查询文件系统
+            const auto Root = FPaths::GetPath(Pattern.Path.Left(Index + 1));
+            if (Root.Len() <= FullProjectDir.Len() || !Root.StartsWith(FullProjectDir))
+                continue;
+
+            Pattern.bIndexed = true;
+            if (IndexedDirectories.Contains(Root))
+                continue;
+
+            IndexedDirectories.Add(Root);
+            IndexDirectory(Root);
+        }
+    }
+
+    void FLuaModuleResolver::IndexDirectory(const FString& Directory)
+    {
+        auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        if (!PlatformFile.DirectoryExists(*Directory))
+            return;
+
+        PlatformFile.IterateDirectoryRecursively(*Directory, [this](const TCHAR* Path, bool bIsDirectory)
+        {
+            if (!bIsDirectory)
+                Files.Add(FPaths::ConvertRelativePathToFull(Path));
+            return true;
+        });
+    }
+}
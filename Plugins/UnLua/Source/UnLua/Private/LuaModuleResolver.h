@@ -0,0 +1,68 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnLua
+{
+    /**
+     * Resolve module names to script files by the patterns of UnLua.PackagePath
+     *
+     * Directories in front of the '?' of each project dir pattern are indexed once, so lookups of files under them never
+     * touch the file system. Resolved paths and misses are cached until the package path changes or InvalidateAll is
+     * called. Patterns under the persistent download dir are checked on the file system every time, since scripts may
+     * be downloaded at any moment.
+     */
+    class UNLUA_API FLuaModuleResolver
+    {
+    public:
+        /**
+         * Find the file of a module, files under the persistent download dir take precedence over the project dir
+         * @return false if no file matches
+         */
+        bool Resolve(const FString& PackagePath, const FString& ModuleName, FString& OutFullPath);
+
+        /**
+         * Forget a resolved file that failed to load
+         */
+        void Forget(const FString& ModuleName, const FString& FullPath);
+
+        /**
+         * Drop the caches of all resolvers, call it after script files are added, removed or downloaded
+         */
+        static void InvalidateAll();
+
+    private:
+        void Reset(const FString& PackagePath);
+
+        void IndexDirectory(const FString& Directory);
+
+        struct FPattern
+        {
+            FString Path; // absolute path, '?' stands for the module path
+            bool bIndexed;
+            bool bDownload; // under the persistent download dir, never indexed or cached
+        };
+
+        static int32 Generation;
+
+        int32 CachedGeneration = INDEX_NONE;
+        FString CachedPackagePath;
+        TArray<FPattern> Patterns;
+        TSet<FString> Files; // absolute paths of all files under the indexed directories
+        TMap<FString, FString> Resolved;
+        TSet<FString> Missing;
+    };
+}
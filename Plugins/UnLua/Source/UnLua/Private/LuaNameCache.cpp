@@ -0,0 +1,87 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#include "LuaNameCache.h"
+
+namespace UnLua
+{
+    FNameCache::FNameCache(lua_State* L)
+        : TableRef(LUA_NOREF), NumSlots(0)
+    {
+        Reset(L);
+    }
+
+    void FNameCache::Push(lua_State* L, FName Name)
+    {
+        const FSlotKey Key = GetSlotKey(Name);
+        const int32* Slot = Slots.Find(Key);
+        if (!Slot && Slots.Num() + Names.Num() >= Capacity)
+            Reset(L);
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, TableRef);
+        if (Slot)
+        {
+            lua_rawgeti(L, -1, *Slot);
+            lua_remove(L, -2);
+            return;
+        }
+
+        lua_pushstring(L, TCHAR_TO_UTF8(*Name.ToString()));
+        lua_pushvalue(L, -1);
+        lua_rawseti(L, -3, ++NumSlots);
+        lua_remove(L, -2);
+        Slots.Add(Key, NumSlots);
+        Names.Add(lua_tostring(L, -1), Name);
+    }
+
+    FName FNameCache::ToName(lua_State* L, int32 Index)
+    {
+        size_t Length;
+        const char* String = lua_tolstring(L, Index, &Length);
+        if (!String)
+            return NAME_None;
+
+        if (const FName* Cached = Names.Find(String))
+            return *Cached;
+
+        const FName Name(UTF8_TO_TCHAR(String));
+        if (Length <= MaxShortStringLength)
+        {
+            if (Slots.Num() + Names.Num() >= Capacity)
+                Reset(L);
+            Anchor(L, Index);
+            Names.Add(String, Name);
+        }
+        return Name;
+    }
+
+    void FNameCache::Reset(lua_State* L)
+    {
+        if (TableRef != LUA_NOREF)
+            luaL_unref(L, LUA_REGISTRYINDEX, TableRef);
+        lua_createtable(L, Capacity, 0);
+        TableRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        NumSlots = 0;
+        Slots.Reset();
+        Names.Reset();
+    }
+
+    void FNameCache::Anchor(lua_State* L, int32 Index)
+    {
+        Index = lua_absindex(L, Index);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, TableRef);
+        lua_pushvalue(L, Index);
+        lua_rawseti(L, -2, ++NumSlots);
+        lua_pop(L, 1);
+    }
+}
@@ -0,0 +1,64 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "lua.hpp"
+
+namespace UnLua
+{
+    /**
+     * Cache of Lua strings for FNames
+     *
+     * Strings are anchored in a Lua table, so their addresses stay unique and can be mapped back to FNames without
+     * converting or hashing the content. The cache is dropped as a whole when it grows over its capacity.
+     */
+    class FNameCache
+    {
+    public:
+        explicit FNameCache(lua_State* L);
+
+        /**
+         * Push the Lua string of a FName
+         */
+        void Push(lua_State* L, FName Name);
+
+        /**
+         * Get the FName of a Lua string at the given stack index
+         */
+        FName ToName(lua_State* L, int32 Index);
+
+    private:
+        void Reset(lua_State* L);
+
+        void Anchor(lua_State* L, int32 Index);
+
+#if WITH_CASE_PRESERVING_NAME
+        // FName comparison ignores case, key on the display entry so each casing gets its own string
+        using FSlotKey = TPair<FNameEntryId, int32>;
+        static FORCEINLINE FSlotKey GetSlotKey(FName Name) { return FSlotKey(Name.GetDisplayIndex(), Name.GetNumber()); }
+#else
+        using FSlotKey = FName;
+        static FORCEINLINE FSlotKey GetSlotKey(FName Name) { return Name; }
+#endif
+
+        static constexpr int32 Capacity = 8192;
+        static constexpr size_t MaxShortStringLength = 40; // LUAI_MAXSHORTLEN, only short strings are internalized
+
+        int32 TableRef;
+        int32 NumSlots;
+        TMap<FSlotKey, int32> Slots;
+        TMap<const char*, FName> Names;
+    };
+}
@@ -5,6 +5,8 @@
 
 namespace UnLua
 {
+    uint32 FLuaOverrides::Generation = 1;
+
     FLuaOverrides& FLuaOverrides::Get()
     {
         static FLuaOverrides Override;
@@ -14,6 +16,9 @@ namespace UnLua
     FLuaOverrides::FLuaOverrides()
     {
         GUObjectArray.AddUObjectDeleteListener(this);
+#if WITH_EDITOR && !UE_VERSION_OLDER_THAN(5, 1, 0)
+        FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FLuaOverrides::OnObjectsReplaced);
+#endif
     }
 
     void FLuaOverrides::NotifyUObjectDeleted(const UObjectBase* Object, int32 Index)
@@ -35,6 +40,7 @@ namespace UnLua
 
     void FLuaOverrides::Override(UFunction* Function, UClass* Class, FName NewName)
     {
+        ++Generation;
         const auto OverridesClass = GetOrAddOverridesClass(Class);
 
         ULuaFunction* LuaFunction;
@@ -83,6 +89,7 @@ namespace UnLua
 
     void FLuaOverrides::Restore(UClass* Class)
     {
+        ++Generation;
         TWeakObjectPtr<ULuaOverridesClass> OverridesClass;
         if ( !Overrides.RemoveAndCopyValue( Class, OverridesClass) )
             return;
@@ -103,6 +110,7 @@ namespace UnLua
 
     void FLuaOverrides::Suspend(UClass* Class)
     {
+        ++Generation;
         if (const auto Exists = Overrides.Find(Class))
         {
             if ( Exists != nullptr && Exists->IsValid() )
@@ -114,6 +122,7 @@ namespace UnLua
 
     void FLuaOverrides::Resume(UClass* Class)
     {
+        ++Generation;
         if (const auto Exists = Overrides.Find(Class))
         {
             if ( Exists != nullptr && Exists->IsValid() )
@@ -123,6 +132,14 @@ namespace UnLua
         }
     }
 
+#if WITH_EDITOR && !UE_VERSION_OLDER_THAN(5, 1, 0)
+    void FLuaOverrides::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+    {
+        // 蓝图重编译会替换UClass下的UFunction
+        ++Generation;
+    }
+#endif
+
     UClass* FLuaOverrides::GetOrAddOverridesClass(UClass* Class)
     {
         const auto Exists = Overrides.Find(Class);
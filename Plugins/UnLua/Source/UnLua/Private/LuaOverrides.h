@@ -16,6 +16,7 @@
 #pragma once
 
 #include "LuaOverridesClass.h"
+#include "Misc/EngineVersionComparison.h"
 
 namespace UnLua
 {
@@ -55,13 +56,25 @@ namespace UnLua
          */
         void Resume(UClass* Class);
 
+        /**
+         * 获取当前的分派世代号，任何覆写变更或蓝图重编译后都会递增。
+         * 用于让缓存了UFunction分派结果的地方失效，UClass销毁由缓存自身的弱指针处理。
+         */
+        static FORCEINLINE uint32 GetGeneration() { return Generation; }
+
     private:
         /**
          * 获取指定Class所对应的LuaOverridesClass，用于承载所有运行时创建的ULuaFunction
          */
         UClass* GetOrAddOverridesClass(UClass* Class);
 
+#if WITH_EDITOR && !UE_VERSION_OLDER_THAN(5, 1, 0)
+        void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+#endif
+
         TMap<UClass*, TWeakObjectPtr<ULuaOverridesClass>> Overrides;
+
+        static uint32 Generation;
      
     };
 }
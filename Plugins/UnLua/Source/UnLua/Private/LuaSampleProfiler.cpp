@@ -0,0 +1,228 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#include "LuaSampleProfiler.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformStackWalk.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "LuaEnv.h"
+#include "LuaInternalHeaders.h"
+
+namespace UnLua
+{
+    TUniquePtr<FSampleProfiler> FSampleProfiler::Instance;
+
+    void FSampleProfiler::Start(FLuaEnv* Env, int32 Frequency)
+    {
+        Stop();
+        Instance.Reset(new FSampleProfiler(Env, FMath::Clamp(Frequency, 1, 10000)));
+        Instance->Thread = FRunnableThread::Create(Instance.Get(), TEXT("LuaSampleProfiler"), 0, TPri_AboveNormal);
+    }
+
+    void FSampleProfiler::Stop()
+    {
+        if (!Instance || !Instance->bRunning)
+            return;
+
+        Instance->bRunning = false;
+        Instance->Thread->WaitForCompletion();
+        delete Instance->Thread;
+        Instance->Thread = nullptr;
+
+        if (!Instance->L)
+            return;
+        Instance->Env->GetAsyncHook()->Cancel(FLuaAsyncHook::Sample);
+        Instance->Fold();
+        Instance->ReleaseFrames();
+    }
+
+    bool FSampleProfiler::IsRunning()
+    {
+        return Instance && Instance->bRunning;
+    }
+
+    FString FSampleProfiler::Dump(const FString& FilePath)
+    {
+        if (!Instance)
+            return FString();
+
+        Instance->Fold();
+        if (Instance->FoldedStacks.Num() == 0)
+            return FString();
+
+        FString Text;
+        for (const auto& Pair : Instance->FoldedStacks)
+            Text += FString::Printf(TEXT("%s %u\n"), *Pair.Key, Pair.Value);
+
+        FString Path = FilePath;
+        if (Path.IsEmpty())
+            Path = FPaths::ProfilingDir() / TEXT("UnLua") / FString::Printf(TEXT("Samples-%s.folded"), *FDateTime::Now().ToString());
+        if (!FFileHelper::SaveStringToFile(Text, *Path))
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("failed to write lua samples to %s"), *Path);
+            return FString();
+        }
+        UE_LOG(LogUnLua, Log, TEXT("%llu lua samples in %d stacks."), Instance->TotalSamples, Instance->FoldedStacks.Num());
+        return Path;
+    }
+
+    void FSampleProfiler::Sample(lua_State* L)
+    {
+        if (Instance && Instance->bRunning && Instance->L == L)
+            Instance->Capture(L);
+    }
+
+    FSampleProfiler::FSampleProfiler(FLuaEnv* InEnv, int32 Frequency)
+        : Env(InEnv),
+          L(InEnv->GetMainState()),
+          Interval(1.0f / Frequency),
+          ArmCycles(0),
+          bRunning(true),
+          Thread(nullptr),
+          TotalSamples(0)
+    {
+        // 挂钩等待超过两个采样周期说明期间没有执行Lua，丢弃这类样本避免统计偏向入口函数
+        MaxLatencyCycles = (uint64)(2.0 * Interval / FPlatformTime::GetSecondsPerCycle64());
+
+        lua_newtable(L);
+        AnchorsRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        OnEnvDestroyedHandle = FLuaEnv::OnDestroyed.AddLambda([this](FLuaEnv& Destroyed)
+        {
+            if (&Destroyed != Env)
+                return;
+            Stop();
+            L = nullptr;
+        });
+    }
+
+    FSampleProfiler::~FSampleProfiler()
+    {
+        FLuaEnv::OnDestroyed.Remove(OnEnvDestroyedHandle);
+    }
+
+    uint32 FSampleProfiler::Run()
+    {
+        while (bRunning)
+        {
+            FPlatformProcess::Sleep(Interval);
+            ArmCycles = FPlatformTime::Cycles64();
+            Env->GetAsyncHook()->Request(FLuaAsyncHook::Sample);
+        }
+        return 0;
+    }
+
+    void FSampleProfiler::Capture(lua_State* InL)
+    {
+        if (FPlatformTime::Cycles64() - ArmCycles > MaxLatencyCycles)
+            return;
+
+        // 挂钩内只记录原始帧指针，命名和折叠推迟到导出时
+        FStack Stack;
+        Stack.Depth = 0;
+        for (CallInfo* CI = InL->ci; CI != &InL->base_ci && Stack.Depth < MaxDepth; CI = CI->previous)
+        {
+#if LUA_VERSION_RELEASE_NUM >= 50406
+            const TValue* Func = s2v(CI->func.p);
+#else
+            const TValue* Func = s2v(CI->func);
+#endif
+            if (ttisLclosure(Func))
+            {
+                LClosure* Closure = clLvalue(Func);
+                Stack.Frames[Stack.Depth++] = Closure->p;
+                if (LuaFrames.Contains(Closure->p))
+                    continue;
+
+                // 锚定闭包，会话期间原型不会被回收，地址也就不会被其他函数复用
+                LuaFrames.Add(Closure->p);
+                lua_rawgeti(InL, LUA_REGISTRYINDEX, AnchorsRef);
+#if LUA_VERSION_RELEASE_NUM >= 50406
+                setclLvalue2s(InL, InL->top.p, Closure);
+                InL->top.p++;
+#else
+                setclLvalue2s(InL, InL->top, Closure);
+                InL->top++;
+#endif
+                lua_rawseti(InL, -2, LuaFrames.Num());
+                lua_pop(InL, 1);
+            }
+            else if (ttislcf(Func))
+            {
+                Stack.Frames[Stack.Depth++] = (const void*)fvalue(Func);
+            }
+            else if (ttisCclosure(Func))
+            {
+                Stack.Frames[Stack.Depth++] = (const void*)clCvalue(Func)->f;
+            }
+        }
+
+        if (Stack.Depth == 0)
+            return;
+        RawStacks.FindOrAdd(Stack)++;
+        TotalSamples++;
+    }
+
+    void FSampleProfiler::Fold()
+    {
+        for (const auto& Pair : RawStacks)
+        {
+            const FStack& Stack = Pair.Key;
+            FString Folded;
+            for (int32 Depth = Stack.Depth - 1; Depth >= 0; Depth--)
+            {
+                if (!Folded.IsEmpty())
+                    Folded += TEXT(";");
+                Folded += GetFrameName(Stack.Frames[Depth]);
+            }
+            FoldedStacks.FindOrAdd(Folded) += Pair.Value;
+        }
+        RawStacks.Reset();
+    }
+
+    void FSampleProfiler::ReleaseFrames()
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, AnchorsRef);
+        AnchorsRef = LUA_NOREF;
+        LuaFrames.Reset();
+        FrameNames.Reset();
+    }
+
+    const FString& FSampleProfiler::GetFrameName(const void* Frame)
+    {
+        if (const auto Exists = FrameNames.Find(Frame))
+            return *Exists;
+
+        FString Name;
+        if (LuaFrames.Contains(Frame))
+        {
+            const auto P = (const Proto*)Frame;
+            const char* Chunk = P->source ? getstr(P->source) : "?";
+            if (*Chunk == '@' || *Chunk == '=')
+                Chunk++;
+            Name = FString::Printf(TEXT("%s:%d"), UTF8_TO_TCHAR(Chunk), P->linedefined);
+        }
+        else
+        {
+            FProgramCounterSymbolInfo SymbolInfo;
+            FPlatformStackWalk::ProgramCounterToSymbolInfo((uint64)Frame, SymbolInfo);
+            Name = SymbolInfo.FunctionName[0] ? FString(ANSI_TO_TCHAR(SymbolInfo.FunctionName)) : FString::Printf(TEXT("[C] %p"), Frame);
+        }
+
+        // 折叠格式以分号分隔帧、以空格分隔计数
+        Name.ReplaceCharInline(TEXT(';'), TEXT(':'));
+        Name.ReplaceCharInline(TEXT(' '), TEXT('_'));
+        return FrameNames.Add(Frame, MoveTemp(Name));
+    }
+}
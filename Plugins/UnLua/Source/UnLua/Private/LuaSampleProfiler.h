@@ -0,0 +1,104 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 Tencent. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "lua.hpp"
+#include <atomic>
+
+namespace UnLua
+{
+    class FLuaEnv;
+
+    /**
+     * Sample Lua stacks of the main thread at a fixed rate and output folded stacks for flame graphs
+     *
+     * A background thread requests a sample through FLuaAsyncHook when one is due, so nothing is executed between
+     * samples and the dead loop check keeps working. Samples are folded by raw frame pointers, frames are named only
+     * when the stacks are dumped or the session stops.
+     */
+    class FSampleProfiler final : public FRunnable
+    {
+    public:
+        static void Start(FLuaEnv* Env, int32 Frequency);
+
+        static void Stop();
+
+        static bool IsRunning();
+
+        /**
+         * Write the folded stacks collected by the last session
+         *
+         * @return - the path of the file, empty if nothing was sampled
+         */
+        static FString Dump(const FString& FilePath = FString());
+
+        /**
+         * Take a sample, called by the hook on the main thread
+         */
+        static void Sample(lua_State* L);
+
+        virtual uint32 Run() override;
+
+        virtual ~FSampleProfiler() override;
+
+    private:
+        static constexpr int32 MaxDepth = 32;
+
+        struct FStack
+        {
+            int32 Depth;
+            const void* Frames[MaxDepth];
+
+            FORCEINLINE bool operator==(const FStack& Other) const
+            {
+                return Depth == Other.Depth && FMemory::Memcmp(Frames, Other.Frames, Depth * sizeof(void*)) == 0;
+            }
+
+            friend FORCEINLINE uint32 GetTypeHash(const FStack& Stack)
+            {
+                return FCrc::MemCrc32(Stack.Frames, Stack.Depth * sizeof(void*));
+            }
+        };
+
+        FSampleProfiler(FLuaEnv* InEnv, int32 Frequency);
+
+        void Capture(lua_State* L);
+
+        void Fold();
+
+        void ReleaseFrames();
+
+        const FString& GetFrameName(const void* Frame);
+
+        static TUniquePtr<FSampleProfiler> Instance;
+
+        FLuaEnv* Env;
+        lua_State* L;
+        float Interval;
+        uint64 MaxLatencyCycles;
+        std::atomic<uint64> ArmCycles;
+        std::atomic<bool> bRunning;
+        FRunnableThread* Thread;
+        FDelegateHandle OnEnvDestroyedHandle;
+
+        int32 AnchorsRef;             // closures of sampled Lua frames, their prototypes stay alive until the session stops
+        TSet<const void*> LuaFrames;  // prototypes of sampled Lua frames, the other frames are C functions
+        TMap<FStack, uint32> RawStacks;
+        uint64 TotalSamples;
+        TMap<const void*, FString> FrameNames;
+        TMap<FString, uint32> FoldedStacks;
+    };
+}
@@ -18,6 +18,7 @@
 #include "DefaultParamCollection.h"
 #include "LowLevel.h"
 #include "LuaFunction.h"
+#include "LuaOverrides.h"
 #include "UnLua.h"
 #include "UnLuaDebugBase.h"
 #include "Kismet/GameplayStatics.h"
@@ -25,12 +26,36 @@
 #include "LuaDeadLoopCheck.h"
 #include "Containers/StaticBitArray.h"
 
+/**
+ * Get a parameter buffer for this function, small frames are allocated on the native stack of the caller
+ */
+#define UNLUA_GET_PARAM_BUFFER(L) \
+    (ParmsSize > UNLUA_MAX_STACK_PARAM_BUFFER_SIZE ? PushParamBuffer(L) : ParmsSize > 0 ? FMemory_Alloca_Aligned(ParmsSize, 16) : nullptr)
+
+bool FFunctionDesc::bEnableNativeFastPath = false;
+bool FFunctionDesc::bEnableStructParamViews = false;
+
+/**
+ * Test if a parameter can be passed to a native thunk without ProcessEvent
+ */
+static bool IsNativeFastPathParam(const FProperty* Property)
+{
+    if (Property->ArrayDim != 1)
+        return false;
+    if (Property->IsA<FNumericProperty>() || Property->IsA<FBoolProperty>() || Property->IsA<FEnumProperty>() || Property->IsA<FObjectProperty>())
+        return true;
+    if (Property->IsA<FStructProperty>())
+        return Property->HasAnyPropertyFlags(CPF_IsPlainOldData) && Property->GetSize() <= 64;
+    return false;
+}
+
 /**
  * Function descriptor constructor
  */
 FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefaultParams)
     : DefaultParams(InDefaultParams), ReturnPropertyIndex(INDEX_NONE), LatentPropertyIndex(INDEX_NONE)
-    , bStaticFunc(false), bInterfaceFunc(false)
+    , ReturnArgIndex(INDEX_NONE), LatentArgIndex(INDEX_NONE), DefaultsArgIndex(0), DefaultsOffset(0)
+    , bStaticFunc(false), bInterfaceFunc(false), bNetFunc(false), bCheckCallspace(false), bNativeFastPath(false), bHasStructParams(false), NativeFunc(nullptr)
 {
     check(InFunction);
 
@@ -38,7 +63,9 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
     FuncName = InFunction->GetName();
     ParmsSize = InFunction->ParmsSize;
 
-    if (InFunction->HasAnyFunctionFlags(FUNC_Net))
+    bNetFunc = InFunction->HasAnyFunctionFlags(FUNC_Net);
+    bCheckCallspace = InFunction->HasAnyFunctionFlags(FUNC_Net | FUNC_BlueprintAuthorityOnly | FUNC_BlueprintCosmetic | FUNC_Static);
+    if (bNetFunc)
         LuaFunctionName = MakeUnique<FTCHARToUTF8>(*FString::Printf(TEXT("%s_RPC"), *FuncName));
     else
         LuaFunctionName = MakeUnique<FTCHARToUTF8>(*FuncName);
@@ -48,8 +75,6 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
     const auto OuterClass = Cast<UClass>(InFunction->GetOuter());
     bInterfaceFunc = OuterClass && OuterClass->HasAnyClassFlags(CLASS_Interface) && OuterClass != UInterface::StaticClass();
 
-    Buffer = FParamBufferFactory::Get(*InFunction);
-
     static const FName NAME_LatentInfo = TEXT("LatentInfo");
     Properties.Reserve(InFunction->NumParms);
     for (TFieldIterator<FProperty> It(InFunction); It && (It->PropertyFlags & CPF_Parm); ++It)
@@ -57,6 +82,9 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
         FProperty *Property = *It;
         FPropertyDesc* PropertyDesc = FPropertyDesc::Create(Property);
         int32 Index = Properties.Add(TUniquePtr<FPropertyDesc>(PropertyDesc));
+        if (!PropertyDesc->IsReturnParameter() && !PropertyDesc->IsOutParameter() && Property->IsA<FStructProperty>())
+            bHasStructParams = true;
+
         if (PropertyDesc->IsReturnParameter())
         {
             ReturnPropertyIndex = Index;                                // return property
@@ -73,6 +101,147 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
             }
         }
     }
+
+    CompileCallPlan();
+
+    if (bEnableNativeFastPath && InFunction->HasAnyFunctionFlags(FUNC_Native) && InFunction->GetNativeFunc() && !ULuaFunction::Get(InFunction)
+        && !InFunction->HasAnyFunctionFlags(FUNC_Net | FUNC_BlueprintAuthorityOnly | FUNC_BlueprintCosmetic) && !bInterfaceFunc && !IsLatentFunction())
+    {
+        bNativeFastPath = true;
+        for (const auto& PropertyDesc : Properties)
+        {
+            FProperty* Property = PropertyDesc->GetProperty();
+            if (!IsNativeFastPathParam(Property))
+            {
+                bNativeFastPath = false;
+                NativeOutProperties.Empty();
+                break;
+            }
+            if (Property->HasAnyPropertyFlags(CPF_OutParm))
+                NativeOutProperties.Add(Property);
+        }
+        NativeFunc = InFunction->GetNativeFunc();
+    }
+}
+
+/**
+ * Flatten the parameter properties into a call plan, so PreCall/PostCall don't need to re-test every property per call
+ */
+void FFunctionDesc::CompileCallPlan()
+{
+    const auto GetOpKind = [](const FProperty* Property)
+    {
+        if (Property->ArrayDim != 1)
+            return FParamOp::Generic;
+        if (Property->IsA<FIntProperty>())
+            return FParamOp::Int32;
+        if (Property->IsA<FFloatProperty>())
+            return FParamOp::Float;
+        if (Property->IsA<FDoubleProperty>())
+            return FParamOp::Double;
+        const auto BoolProperty = CastField<FBoolProperty>(Property);
+        if (BoolProperty && BoolProperty->IsNativeBool())
+            return FParamOp::Bool;
+        return FParamOp::Generic;
+    };
+
+    int32 ArgIndex = 0;
+    for (int32 i = 0; i < Properties.Num(); ++i)
+    {
+        const auto& PropertyDesc = Properties[i];
+        const FProperty* Property = PropertyDesc->GetProperty();
+
+        // zero constructed properties are covered by the memzero of the whole buffer
+        if (!Property->HasAnyPropertyFlags(CPF_ZeroConstructor))
+            ConstructIndices.Add(i);
+        if (!Property->HasAnyPropertyFlags(CPF_NoDestructor))
+            DestructIndices.Add(i);
+
+        // latent info and return property don't consume a Lua argument
+        if (i == LatentPropertyIndex)
+        {
+            LatentArgIndex = ArgIndex;
+            continue;
+        }
+        if (i == ReturnPropertyIndex)
+        {
+            ReturnArgIndex = ArgIndex;
+            continue;
+        }
+
+        FParamOp& Op = InputOps.AddDefaulted_GetRef();
+        Op.Property = PropertyDesc.Get();
+        Op.Offset = Property->GetOffset_ForInternal();
+        Op.PropertyIndex = i;
+        Op.ArgIndex = ArgIndex++;
+        Op.Kind = GetOpKind(Property);
+        Op.bOutParm = PropertyDesc->IsOutParameter();
+
+        // bind default value to the parameter slot
+        Op.DefaultValue = nullptr;
+        if (DefaultParams && !Op.bOutParm)
+        {
+            IParamValue** DefaultValue = DefaultParams->Parameters.Find(Property->GetFName());
+            if (DefaultValue)
+                Op.DefaultValue = (*DefaultValue)->GetValue();
+        }
+    }
+
+    CompileDefaultsTemplate();
+}
+
+/**
+ * Prebuild the trailing POD parameters with their default values, so omitted arguments can be filled with one block copy
+ */
+void FFunctionDesc::CompileDefaultsTemplate()
+{
+    DefaultsArgIndex = InputOps.Num();
+    if (!DefaultParams || InputOps.Num() == 0)
+        return;
+
+    const auto& LastOp = InputOps.Last();
+    const int32 EndOffset = LastOp.Offset + LastOp.Property->GetProperty()->GetSize();
+
+    bool bHasDefault = false;
+    for (int32 i = InputOps.Num() - 1; i >= 0; --i)
+    {
+        const auto& Op = InputOps[i];
+        if (!Op.Property->IsPODType())
+            break;
+        if (i < InputOps.Num() - 1 && Op.Offset + Op.Property->GetProperty()->GetSize() > InputOps[i + 1].Offset)
+            break;
+        DefaultsArgIndex = i;
+        bHasDefault |= Op.DefaultValue != nullptr;
+    }
+
+    // latent info and return property must stay out of the block
+    for (const int32 Index : {LatentPropertyIndex, ReturnPropertyIndex})
+    {
+        if (Index == INDEX_NONE)
+            continue;
+        const int32 Offset = Properties[Index]->GetProperty()->GetOffset_ForInternal();
+        while (DefaultsArgIndex < InputOps.Num() && InputOps[DefaultsArgIndex].Offset <= Offset && Offset < EndOffset)
+            ++DefaultsArgIndex;
+    }
+
+    if (!bHasDefault || DefaultsArgIndex == InputOps.Num())
+    {
+        DefaultsArgIndex = InputOps.Num();
+        return;
+    }
+
+    DefaultsOffset = InputOps[DefaultsArgIndex].Offset;
+    uint8* Frame = (uint8*)FMemory::Malloc(ParmsSize, 16);
+    FMemory::Memzero(Frame, ParmsSize);
+    for (int32 i = DefaultsArgIndex; i < InputOps.Num(); ++i)
+    {
+        const auto& Op = InputOps[i];
+        Op.Property->InitializeValue(Frame);
+        if (Op.DefaultValue)
+            Op.Property->CopyValue(Frame, Op.DefaultValue);
+    }
+    DefaultsTemplate.Append(Frame + DefaultsOffset, EndOffset - DefaultsOffset);
+    FMemory::Free(Frame);
 }
 
 void FFunctionDesc::CallLua(lua_State* L, lua_Integer FunctionRef, lua_Integer SelfRef, FFrame& Stack, RESULT_DECL)
@@ -80,6 +249,7 @@ void FFunctionDesc::CallLua(lua_State* L, lua_Integer FunctionRef, lua_Integer S
 #if ENABLE_UNREAL_INSIGHTS && CPUPROFILERTRACE_ENABLED
     TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*FuncName);
 #endif
+    UnLua::FCallProfiler::FScope Profile(Function.Get(), true);
     
     lua_pushcfunction(L, UnLua::ReportLuaCallError);
     check(Function.IsValid());
@@ -93,7 +263,9 @@ void FFunctionDesc::CallLua(lua_State* L, lua_Integer FunctionRef, lua_Integer S
     const bool bUnpackParams = Stack.CurrentNativeFunction && Stack.Node != Stack.CurrentNativeFunction;
     if (bUnpackParams)
     {
-        InParms = Buffer->Get();
+        InParms = UNLUA_GET_PARAM_BUFFER(L);
+        if (InParms)
+            FMemory::Memzero(InParms, ParmsSize);
 
         FOutParmRec* FirstOut = nullptr;
         FOutParmRec* LastOut = nullptr;
@@ -143,10 +315,10 @@ void FFunctionDesc::CallLua(lua_State* L, lua_Integer FunctionRef, lua_Integer S
         InParms = Stack.Locals;
     }
 
-    CallLuaInternal(L, InParms , OutParms, RESULT_PARAM);
+    CallLuaInternal(L, InParms, OutParms, RESULT_PARAM, Profile);
 
-    if (bUnpackParams && InParms)
-        Buffer->Pop(InParms);
+    if (bUnpackParams)
+        PopParamBuffer(L, InParms);
 }
 
 bool FFunctionDesc::CallLua(lua_State* L, int32 LuaRef, void* Params, UObject* Self)
@@ -154,6 +326,7 @@ bool FFunctionDesc::CallLua(lua_State* L, int32 LuaRef, void* Params, UObject* S
 #if ENABLE_UNREAL_INSIGHTS && CPUPROFILERTRACE_ENABLED
     TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*FuncName);
 #endif
+    UnLua::FCallProfiler::FScope Profile(Function.Get(), true);
     
     bool bOk = PushFunction(L, Self, LuaRef);
     if (!bOk)
@@ -161,7 +334,7 @@ bool FFunctionDesc::CallLua(lua_State* L, int32 LuaRef, void* Params, UObject* S
 
     const bool bHasReturnParam = Function->ReturnValueOffset != MAX_uint16;
     uint8* ReturnValueAddress = bHasReturnParam ? ((uint8*)Params + Function->ReturnValueOffset) : nullptr;
-    bOk = CallLuaInternal(L, Params, nullptr, ReturnValueAddress);
+    bOk = CallLuaInternal(L, Params, nullptr, ReturnValueAddress, Profile);
     return bOk;
 }
 
@@ -173,6 +346,7 @@ int32 FFunctionDesc::CallUE(lua_State *L, int32 NumParams, void *Userdata)
 #if ENABLE_UNREAL_INSIGHTS && CPUPROFILERTRACE_ENABLED
     TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*FuncName);
 #endif
+    UnLua::FCallProfiler::FScope Profile(Function.Get(), false);
 
     check(Function.IsValid());
 
@@ -199,41 +373,208 @@ int32 FFunctionDesc::CallUE(lua_State *L, int32 NumParams, void *Userdata)
     if (UNLIKELY(!CheckObject(Object, Error)))
         return luaL_error(L, TCHAR_TO_UTF8(*Error));
 
-    int32 Callspace = Object->GetFunctionCallspace(Function.Get(), nullptr);
-    bool bRemote = Callspace & FunctionCallspace::Remote;
-    bool bLocal = Callspace & FunctionCallspace::Local;
-
     FFlagArray CleanupFlags;
-    const auto Params = Buffer->Get(); 
+    const auto Params = UNLUA_GET_PARAM_BUFFER(L);
     PreCall(L, NumParams, FirstParamIndex, CleanupFlags, Params, Userdata);      // prepare values of properties
-    auto FinalFunction = bInterfaceFunc
-                             ? Object->GetClass()->FindFunctionByName(Function->GetFName())
-                             : Function.Get();
+    Profile.BeginBody();
+    Dispatch(Object, Params);
+    Profile.EndBody();
+    int32 NumReturnValues = PostCall(L, NumParams, FirstParamIndex, Params, CleanupFlags);      // push 'out' properties to Lua stack
+    PopParamBuffer(L, Params);
+    return NumReturnValues;
+}
 
-#if ENABLE_CALL_OVERRIDDEN_FUNCTION
-    if (!Function->HasAnyFunctionFlags(FUNC_Net))
+/**
+ * Call the UFunction on each object of an array
+ */
+int32 FFunctionDesc::CallUEBatch(lua_State* L, int32 ObjectsIndex, int32 FirstArgIndex, int32 NumArgs)
+{
+#if ENABLE_UNREAL_INSIGHTS && CPUPROFILERTRACE_ENABLED
+    TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*FuncName);
+#endif
+    UnLua::FCallProfiler::FScope Profile(Function.Get(), false);
+
+    check(Function.IsValid());
+
+    if (bStaticFunc || IsLatentFunction())
+        return luaL_error(L, "attempt to batch call static or latent UFunction '%s'", GetLuaFunctionName());
+
+    const int32 NumObjects = (int32)lua_rawlen(L, ObjectsIndex);
+
+    // plain tables are passed per object, except for container parameters which take a table as a whole
+    TArray<bool, TInlineAllocator<16>> PerObjectArgs;
+    PerObjectArgs.SetNumZeroed(NumArgs);
+    for (int32 i = 0; i < NumArgs && i < InputOps.Num(); ++i)
     {
-        const auto LuaFunction = ULuaFunction::Get(Function.Get());
-        if (LuaFunction && LuaFunction->GetOverridden())
-            FinalFunction = LuaFunction->GetOverridden();
+        const int32 Index = FirstArgIndex + i;
+        if (lua_type(L, Index) != LUA_TTABLE)
+            continue;
+        if (lua_getmetatable(L, Index))
+        {
+            lua_pop(L, 1);
+            continue;
+        }
+
+        const auto Property = InputOps[i].Property->GetProperty();
+        if (Property->IsA<FArrayProperty>() || Property->IsA<FSetProperty>() || Property->IsA<FMapProperty>())
+            continue;
+
+        if ((int32)lua_rawlen(L, Index) != NumObjects)
+            return luaL_error(L, "argument %d of batch call '%s' has %d values for %d objects", i + 1, GetLuaFunctionName(), (int32)lua_rawlen(L, Index), NumObjects);
+        PerObjectArgs[i] = true;
     }
-#endif
+
+    // accept every object inheriting the root declaration, the final function is resolved per class when dispatching
+    const auto LuaFunction = ULuaFunction::Get(Function.Get());
+    UFunction* RootFunction = LuaFunction && LuaFunction->GetOverridden() ? LuaFunction->GetOverridden() : Function.Get();
+    while (RootFunction->GetSuperFunction())
+        RootFunction = RootFunction->GetSuperFunction();
+    const auto TargetClass = RootFunction->GetOwnerClass();
+
+    luaL_checkstack(L, NumArgs + GetNumOutProperties() + 4, "too many arguments for batch call");
+    lua_createtable(L, NumObjects, 0);
+    const int32 ResultsIndex = lua_gettop(L);
+
+    const auto Params = UNLUA_GET_PARAM_BUFFER(L);
+    int32 NumDispatched = 0;
+    for (int32 i = 1; i <= NumObjects; ++i)
+    {
+        lua_rawgeti(L, ObjectsIndex, i);
+        UObject* Object = UnLua::GetUObject(L, ResultsIndex + 1);
+        lua_pop(L, 1);
+
+        FString Error;
+        if (!Object || !CheckObject(Object, Error))
+            continue;
+
+        if (bInterfaceFunc ? !Object->GetClass()->ImplementsInterface(TargetClass) : !Object->IsA(TargetClass))
+        {
+            UNLUA_LOGWARNING(L, LogUnLua, Warning, TEXT("attempt to batch call UFunction '%s' on invalid self type '%s'."), *FuncName, *Object->GetClass()->GetName());
+            continue;
+        }
+
+        for (int32 j = 0; j < NumArgs; ++j)
+        {
+            if (PerObjectArgs[j])
+                lua_rawgeti(L, FirstArgIndex + j, i);
+            else
+                lua_pushvalue(L, FirstArgIndex + j);
+        }
+
+        FFlagArray CleanupFlags;
+        PreCall(L, NumArgs, ResultsIndex + 1, CleanupFlags, Params);
+        Profile.BeginBody();
+        Dispatch(Object, Params);
+        Profile.EndBody();
+        ++NumDispatched;
+        const int32 NumReturnValues = PostCall(L, NumArgs, ResultsIndex + 1, Params, CleanupFlags);
+        if (NumReturnValues == 1)
+        {
+            lua_rawseti(L, ResultsIndex, i);
+        }
+        else if (NumReturnValues > 1)
+        {
+            lua_createtable(L, NumReturnValues, 0);
+            lua_insert(L, -(NumReturnValues + 1));
+            for (int32 k = NumReturnValues; k > 0; --k)
+                lua_rawseti(L, -(k + 1), k);
+            lua_rawseti(L, ResultsIndex, i);
+        }
+        lua_settop(L, ResultsIndex);
+    }
+    PopParamBuffer(L, Params);
+    Profile.SetCalls(NumDispatched);
+    return 1;
+}
+
+/**
+ * Route the call to local or remote
+ */
+void FFunctionDesc::Dispatch(UObject* Object, void* Params)
+{
+    // RPCs, authority only and cosmetic functions depend on the object or net mode, static functions go through the global callspace,
+    // the others are always local
+    bool bRemote = false;
+    bool bLocal = true;
+    if (bCheckCallspace)
+    {
+        const int32 Callspace = Object->GetFunctionCallspace(Function.Get(), nullptr);
+        bRemote = Callspace & FunctionCallspace::Remote;
+        bLocal = Callspace & FunctionCallspace::Local;
+    }
+
+    const auto FinalFunction = GetFinalFunction(Object);
 
     // call the UFuncton...
     // Func_NetMuticast both remote and local
     // local automatic checked remote and local,so local first
     if (bLocal)
-    {   
-        Object->UObject::ProcessEvent(FinalFunction, Params);
+    {
+        // the native thunk is replaced when the function is overridden by Lua
+        if (bNativeFastPath && FinalFunction == Function.Get() && FinalFunction->GetNativeFunc() == NativeFunc)
+            CallNative(Object, Params);
+        else
+            Object->UObject::ProcessEvent(FinalFunction, Params);
     }
     if (bRemote && !bLocal)
     {
         Object->CallRemoteFunction(FinalFunction, Params, nullptr, nullptr);
     }
+}
 
-    int32 NumReturnValues = PostCall(L, NumParams, FirstParamIndex, Params, CleanupFlags);      // push 'out' properties to Lua stack
-    Buffer->Pop(Params);
-    return NumReturnValues;
+/**
+ * Call the native thunk with a minimal frame over the parameter buffer, like ProcessEvent does for native functions
+ */
+void FFunctionDesc::CallNative(UObject* Object, void* Params) const
+{
+    UFunction* Func = Function.Get();
+    FFrame Stack(Object, Func, Params, nullptr, Func->ChildProperties);
+
+    FOutParmRec** LastOut = &Stack.OutParms;
+    for (FProperty* Property : NativeOutProperties)
+    {
+        CA_SUPPRESS(6263)
+        FOutParmRec* Out = (FOutParmRec*)FMemory_Alloca(sizeof(FOutParmRec));
+        Out->PropAddr = Property->ContainerPtrToValuePtr<uint8>(Params);
+        Out->Property = Property;
+        Out->NextOutParm = nullptr;
+        *LastOut = Out;
+        LastOut = &Out->NextOutParm;
+    }
+
+    uint8* ReturnValueAddress = ReturnPropertyIndex > INDEX_NONE ? (uint8*)Params + Func->ReturnValueOffset : nullptr;
+    (*NativeFunc)(Object, Stack, ReturnValueAddress);
+}
+
+/**
+ * Get the UFunction to dispatch for the object, cached per class until overrides or classes change
+ */
+UFunction* FFunctionDesc::GetFinalFunction(UObject* Object)
+{
+    const auto Class = Object->GetClass();
+    const auto Generation = UnLua::FLuaOverrides::GetGeneration();
+    if (DispatchCache.Generation == Generation && DispatchCache.Class.Get() == Class)
+        return DispatchCache.FinalFunction;
+
+    // objects of a batch call may be siblings of the class the function was resolved on
+    const bool bSibling = !bInterfaceFunc && !Class->IsChildOf(Function->GetOwnerClass());
+    auto FinalFunction = bInterfaceFunc || bSibling
+                             ? Class->FindFunctionByName(Function->GetFName())
+                             : Function.Get();
+
+#if ENABLE_CALL_OVERRIDDEN_FUNCTION
+    if (!bNetFunc)
+    {
+        const auto LuaFunction = ULuaFunction::Get(bSibling ? FinalFunction : Function.Get());
+        if (LuaFunction && LuaFunction->GetOverridden())
+            FinalFunction = LuaFunction->GetOverridden();
+    }
+#endif
+
+    DispatchCache.Class = Class;
+    DispatchCache.FinalFunction = FinalFunction;
+    DispatchCache.Generation = Generation;
+    return FinalFunction;
 }
 
 /**
@@ -247,11 +588,11 @@ int32 FFunctionDesc::ExecuteDelegate(lua_State *L, int32 NumParams, int32 FirstP
     }
 
     FFlagArray CleanupFlags;
-    const auto Params = Buffer->Get();
+    const auto Params = UNLUA_GET_PARAM_BUFFER(L);
     PreCall(L, NumParams, FirstParamIndex, CleanupFlags, Params);
     ScriptDelegate->ProcessDelegate<UObject>(Params);
     int32 NumReturnValues = PostCall(L, NumParams, FirstParamIndex, Params, CleanupFlags);
-    Buffer->Pop(Params);
+    PopParamBuffer(L, Params);
     return NumReturnValues;
 }
 
@@ -266,11 +607,75 @@ void FFunctionDesc::BroadcastMulticastDelegate(lua_State *L, int32 NumParams, in
     }
 
     FFlagArray CleanupFlags;
-    const auto Params = Buffer->Get();
+    const auto Params = UNLUA_GET_PARAM_BUFFER(L);
     PreCall(L, NumParams, FirstParamIndex, CleanupFlags, Params);
     ScriptDelegate->ProcessMulticastDelegate<UObject>(Params);
     PostCall(L, NumParams, FirstParamIndex, Params, CleanupFlags);      // !!! have no return values for multi-cast delegates
-    Buffer->Pop(Params);
+    PopParamBuffer(L, Params);
+}
+
+/**
+ * Get a parameter buffer which is too large for the native stack
+ */
+void* FFunctionDesc::PushParamBuffer(lua_State* L) const
+{
+#if ENABLE_PERSISTENT_PARAM_BUFFER
+    return UnLua::FLuaEnv::FindEnvChecked(L).GetParamBufferArena()->Push(ParmsSize);
+#else
+    return FMemory::Malloc(ParmsSize, 16);
+#endif
+}
+
+/**
+ * Release a parameter buffer got by UNLUA_GET_PARAM_BUFFER
+ */
+void FFunctionDesc::PopParamBuffer(lua_State* L, void* Params) const
+{
+    if (ParmsSize <= UNLUA_MAX_STACK_PARAM_BUFFER_SIZE)
+        return;
+
+#if ENABLE_PERSISTENT_PARAM_BUFFER
+    UnLua::FLuaEnv::FindEnvChecked(L).GetParamBufferArena()->Pop(Params);
+#else
+    FMemory::Free(Params);
+#endif
+}
+
+/**
+ * Initialize the parameter buffer
+ */
+void FFunctionDesc::InitializeParams(void* Params) const
+{
+    if (ParmsSize > 0)
+        FMemory::Memzero(Params, ParmsSize);
+
+    for (const int32 Index : ConstructIndices)
+        Properties[Index]->InitializeValue(Params);
+}
+
+/**
+ * Write a Lua argument to the parameter buffer
+ */
+bool FFunctionDesc::WriteParam(lua_State* L, const FParamOp& Op, void* Params, int32 IndexInStack) const
+{
+    uint8* ValuePtr = (uint8*)Params + Op.Offset;
+    switch (Op.Kind)
+    {
+    case FParamOp::Int32:
+        *(int32*)ValuePtr = (int32)lua_tointeger(L, IndexInStack);
+        return false;
+    case FParamOp::Float:
+        *(float*)ValuePtr = (float)lua_tonumber(L, IndexInStack);
+        return false;
+    case FParamOp::Double:
+        *(double*)ValuePtr = (double)lua_tonumber(L, IndexInStack);
+        return false;
+    case FParamOp::Bool:
+        *(bool*)ValuePtr = lua_toboolean(L, IndexInStack) != 0;
+        return false;
+    default:
+        return Op.Property->WriteValue_InContainer(L, Params, IndexInStack, false);
+    }
 }
 
 /**
@@ -278,71 +683,75 @@ void FFunctionDesc::BroadcastMulticastDelegate(lua_State *L, int32 NumParams, in
  */
 void FFunctionDesc::PreCall(lua_State* L, int32 NumParams, int32 FirstParamIndex, FFlagArray& CleanupFlags, void* Params, void* Userdata)
 {
-    int32 ParamIndex = 0;
-    for (int32 i = 0; i < Properties.Num(); ++i)
+    InitializeParams(Params);
+
+    int32 NumOps = InputOps.Num();
+    if (NumParams >= DefaultsArgIndex && NumParams < NumOps)
     {
-        const auto& Property = Properties[i];
-        Property->InitializeValue(Params);
-        if (i == LatentPropertyIndex)
-        {
-            const int32 ThreadRef = *((int32*)Userdata);
-            void* ContainerPtr = (uint8*)Params;// + Property->GetOffset();
-            if(lua_type(L, FirstParamIndex + ParamIndex) == LUA_TUSERDATA)
-            {
-                // custom latent action info
-                FLatentActionInfo Info = UnLua::Get<FLatentActionInfo>(L, FirstParamIndex + ParamIndex, UnLua::TType<FLatentActionInfo>());
-                Property->CopyValue(ContainerPtr, &Info);
-                continue;
-            }
+        // omitted trailing POD parameters
+        const int32 Offset = InputOps[NumParams].Offset;
+        FMemory::Memcpy((uint8*)Params + Offset, DefaultsTemplate.GetData() + (Offset - DefaultsOffset), DefaultsTemplate.Num() - (Offset - DefaultsOffset));
+        NumOps = NumParams;
+    }
 
-            // bind a callback to the latent function
-            auto& Env = UnLua::FLuaEnv::FindEnvChecked(L);
-            FLatentActionInfo LatentActionInfo(ThreadRef, GetTypeHash(FGuid::NewGuid()), TEXT("OnLatentActionCompleted"), (Env.GetManager()));
-            Property->CopyValue(ContainerPtr, &LatentActionInfo);
-            continue;
-        }
-        if (i == ReturnPropertyIndex)
+    for (int32 i = 0; i < NumOps; ++i)
+    {
+        const FParamOp& Op = InputOps[i];
+        const int32 IndexInStack = FirstParamIndex + Op.ArgIndex;
+        if (Op.ArgIndex < NumParams)
         {
-            CleanupFlags[i] = ParamIndex >= NumParams || !Property->CopyBack(L, FirstParamIndex + ParamIndex, Params);
-            continue;
-        }
-        if (ParamIndex < NumParams)
-        {   
 #if ENABLE_TYPE_CHECK == 1
             FString ErrorMsg = "";
-            if (Property->CheckPropertyType(L, FirstParamIndex + ParamIndex, ErrorMsg))
-                CleanupFlags[i] = Property->WriteValue_InContainer(L, Params, FirstParamIndex + ParamIndex, false);
+            if (Op.Property->CheckPropertyType(L, IndexInStack, ErrorMsg))
+                CleanupFlags[Op.PropertyIndex] = WriteParam(L, Op, Params, IndexInStack);
             else
-                UNLUA_LOGERROR(L, LogUnLua, Error, TEXT("Invalid parameter type calling ufunction : %s,parameter : %d, error msg : %s"), *FuncName, ParamIndex, *ErrorMsg);
+                UNLUA_LOGERROR(L, LogUnLua, Error, TEXT("Invalid parameter type calling ufunction : %s,parameter : %d, error msg : %s"), *FuncName, Op.ArgIndex, *ErrorMsg);
 #else
-            CleanupFlags[i] = Property->WriteValue_InContainer(L, Params, FirstParamIndex + ParamIndex, false);
+            CleanupFlags[Op.PropertyIndex] = WriteParam(L, Op, Params, IndexInStack);
 #endif
         }
-        else if (!Property->IsOutParameter())
+        else if (Op.DefaultValue)
+        {
+            // set value for default parameter
+            Op.Property->CopyValue(Params, Op.DefaultValue);
+            CleanupFlags[Op.PropertyIndex] = true;
+        }
+        else if (!DefaultParams && !Op.bOutParm)
         {
-            if (DefaultParams)
+#if ENABLE_TYPE_CHECK == 1
+            FString ErrorMsg = "";
+            if (!Op.Property->CheckPropertyType(L, IndexInStack, ErrorMsg))
             {
-                // set value for default parameter
-                IParamValue **DefaultValue = DefaultParams->Parameters.Find(Property->GetProperty()->GetFName());
-                if (DefaultValue)
-                {
-                    const void *ValuePtr = (*DefaultValue)->GetValue();
-                    Property->CopyValue(Params, ValuePtr);
-                    CleanupFlags[i] = true;
-                }
+                UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("Invalid parameter type calling ufunction : %s,parameter : %d, error msg : %s"), *FuncName, Op.ArgIndex, *ErrorMsg);
             }
-            else
-            {
-#if ENABLE_TYPE_CHECK == 1
-                FString ErrorMsg = "";
-                if (!Property->CheckPropertyType(L, FirstParamIndex + ParamIndex, ErrorMsg))
-                {
-                    UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("Invalid parameter type calling ufunction : %s,parameter : %d, error msg : %s"), *FuncName, ParamIndex, *ErrorMsg);
-                }
 #endif
-            }
         }
-        ++ParamIndex;
+    }
+
+    if (LatentPropertyIndex > INDEX_NONE)
+    {
+        const auto& Property = Properties[LatentPropertyIndex];
+        const int32 IndexInStack = FirstParamIndex + LatentArgIndex;
+        if (lua_type(L, IndexInStack) == LUA_TUSERDATA)
+        {
+            // custom latent action info
+            FLatentActionInfo Info = UnLua::Get<FLatentActionInfo>(L, IndexInStack, UnLua::TType<FLatentActionInfo>());
+            Property->CopyValue(Params, &Info);
+        }
+        else
+        {
+            // bind a callback to the latent function
+            const int32 ThreadRef = *((int32*)Userdata);
+            auto& Env = UnLua::FLuaEnv::FindEnvChecked(L);
+            FLatentActionInfo LatentActionInfo(ThreadRef, Env.NewLatentUUID(), TEXT("OnLatentActionCompleted"), (Env.GetManager()));
+            Property->CopyValue(Params, &LatentActionInfo);
+        }
+    }
+
+    if (ReturnPropertyIndex > INDEX_NONE)
+    {
+        const auto& Property = Properties[ReturnPropertyIndex];
+        CleanupFlags[ReturnPropertyIndex] = ReturnArgIndex >= NumParams || !Property->CopyBack(L, FirstParamIndex + ReturnArgIndex, Params);
     }
 }
 
@@ -398,11 +807,11 @@ int32 FFunctionDesc::PostCall(lua_State * L, int32 NumParams, int32 FirstParamIn
     }
 #endif
 
-    for (int32 i = 0; i < Properties.Num(); ++i)
+    for (const int32 Index : DestructIndices)
     {
-        if (CleanupFlags[i])
+        if (CleanupFlags[Index])
         {
-            Properties[i]->DestroyValue(Params);
+            Properties[Index]->DestroyValue(Params);
         }
     }
 
@@ -428,7 +837,7 @@ static FOutParmRec* FindOutParmRec(FOutParmRec *OutParam, FProperty *OutProperty
 /**
  * Call Lua function that overrides this UFunction. 
  */
-bool FFunctionDesc::CallLuaInternal(lua_State *L, void *InParams, FOutParmRec *OutParams, void *RetValueAddress) const
+bool FFunctionDesc::CallLuaInternal(lua_State *L, void *InParams, FOutParmRec *OutParams, void *RetValueAddress, UnLua::FCallProfiler::FScope& Profile) const
 {
     // -1 = [table/userdata] UObject for self
     // -2 = [function] to call
@@ -436,7 +845,8 @@ bool FFunctionDesc::CallLuaInternal(lua_State *L, void *InParams, FOutParmRec *O
     const auto ErrorHandlerIndex = lua_gettop(L) - 2;
 
     const auto& Env = UnLua::FLuaEnv::FindEnvChecked(L);
-    const auto DanglingGuard = Env.GetDanglingCheck()->MakeGuard();
+    const bool bStructViews = !UNLUA_LEGACY_ARGS_PASSING && bEnableStructParamViews && bHasStructParams;
+    const auto DanglingGuard = Env.GetDanglingCheck()->MakeGuard(bStructViews);
 
     if (InParams)
     {
@@ -446,7 +856,10 @@ bool FFunctionDesc::CallLuaInternal(lua_State *L, void *InParams, FOutParmRec *O
             if (Property->IsReturnParameter())
                 continue;
 
-            Property->ReadValue_InContainer(L, InParams, !UNLUA_LEGACY_ARGS_PASSING);
+            if (bStructViews && !Property->IsOutParameter())
+                Property->ReadValueView_InContainer(L, InParams);
+            else
+                Property->ReadValue_InContainer(L, InParams, !UNLUA_LEGACY_ARGS_PASSING);
         }
     }
 
@@ -456,7 +869,13 @@ bool FFunctionDesc::CallLuaInternal(lua_State *L, void *InParams, FOutParmRec *O
         NumParams++;
 
     const auto Guard = Env.GetDeadLoopCheck()->MakeGuard();
-    if (lua_pcall(L, NumParams, LUA_MULTRET, -(NumParams + 2)) != LUA_OK)
+    const auto Arena = Env.GetParamBufferArena();
+    const auto ArenaMark = Arena->GetMark();
+    Profile.BeginBody();
+    const int32 Status = lua_pcall(L, NumParams, LUA_MULTRET, -(NumParams + 2));
+    Profile.EndBody();
+    Arena->Restore(ArenaMark);
+    if (Status != LUA_OK)
     {
         lua_settop(L, ErrorHandlerIndex - 1);
         return false;
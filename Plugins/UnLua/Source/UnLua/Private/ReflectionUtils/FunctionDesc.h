@@ -19,6 +19,7 @@
 #include "ParamBufferAllocator.h"
 #include "Registries/FunctionRegistry.h"
 #include "ReflectionUtils/PropertyDesc.h"
+#include "LuaCallProfiler.h"
 
 struct FParameterCollection;
 
@@ -87,6 +88,16 @@ public:
      */
     int32 CallUE(lua_State *L, int32 NumParams, void *Userdata = nullptr);
 
+    /**
+     * Call this UFunction on each object of an array, reusing one parameter buffer
+     *
+     * @param ObjectsIndex - Lua index of the table of objects
+     * @param FirstArgIndex - Lua index of the first argument. a plain table argument is passed per object, others are passed to every object
+     * @param NumArgs - the number of arguments
+     * @return - the number of return values pushed on the stack, it's a table with results of each object
+     */
+    int32 CallUEBatch(lua_State *L, int32 ObjectsIndex, int32 FirstArgIndex, int32 NumArgs);
+
     /**
      * Fire the delegate
      *
@@ -106,25 +117,89 @@ public:
      */
     void BroadcastMulticastDelegate(lua_State *L, int32 NumParams, int32 FirstParamIndex, FMulticastScriptDelegate *ScriptDelegate);
 
+    /** Whether eligible native functions are called through their native thunk directly, see UUnLuaSettings */
+    static bool bEnableNativeFastPath;
+
+    /** Whether struct parameters are passed to Lua as borrowed views instead of copies, see UUnLuaSettings */
+    static bool bEnableStructParamViews;
+
 private:
     typedef TStaticBitArray<64U> FFlagArray;
+
+    /**
+     * Marshalling step for a Lua argument, compiled once from the parameter properties
+     */
+    struct FParamOp
+    {
+        enum EKind : uint8
+        {
+            Generic,
+            Int32,
+            Float,
+            Double,
+            Bool,
+        };
+
+        FPropertyDesc* Property;
+        const void* DefaultValue;
+        int32 Offset;
+        int32 PropertyIndex;
+        int32 ArgIndex;
+        EKind Kind;
+        bool bOutParm;
+    };
+
+    /**
+     * Monomorphic inline cache of the UFunction to dispatch for the last seen class, the weak pointer rejects a new class at the address of a deleted one
+     */
+    struct FDispatchCache
+    {
+        TWeakObjectPtr<UClass> Class;
+        UFunction* FinalFunction = nullptr;
+        uint32 Generation = 0;
+    };
+
+    void CompileCallPlan();
+    void CompileDefaultsTemplate();
+    FORCEINLINE UFunction* GetFinalFunction(UObject* Object);
+    FORCEINLINE void Dispatch(UObject* Object, void* Params);
+    FORCENOINLINE void CallNative(UObject* Object, void* Params) const;
+    void* PushParamBuffer(lua_State* L) const;
+    void PopParamBuffer(lua_State* L, void* Params) const;
+    FORCEINLINE void InitializeParams(void* Params) const;
+    FORCEINLINE bool WriteParam(lua_State* L, const FParamOp& Op, void* Params, int32 IndexInStack) const;
+
     void PreCall(lua_State* L, int32 NumParams, int32 FirstParamIndex, FFlagArray& CleanupFlags, void* Params, void* Userdata = nullptr);
     int32 PostCall(lua_State* L, int32 NumParams, int32 FirstParamIndex, void* Params, const FFlagArray& CleanupFlags);
 
-    bool CallLuaInternal(lua_State *L, void *InParams, FOutParmRec *OutParams, void *RetValueAddress) const;
+    bool CallLuaInternal(lua_State *L, void *InParams, FOutParmRec *OutParams, void *RetValueAddress, UnLua::FCallProfiler::FScope& Profile) const;
 
     FORCEINLINE bool CheckObject(UObject* Object, FString& Error) const;
 
     TWeakObjectPtr<UFunction> Function;
     FString FuncName;
-    TSharedPtr<FParamBufferAllocator> Buffer;
     TArray<TUniquePtr<FPropertyDesc>> Properties;
     TArray<int32> OutPropertyIndices;
+    TArray<FParamOp> InputOps;
+    TArray<int32> ConstructIndices;
+    TArray<int32> DestructIndices;
+    TArray<uint8> DefaultsTemplate;
+    int32 DefaultsArgIndex;
+    int32 DefaultsOffset;
     FParameterCollection *DefaultParams;
     int32 ReturnPropertyIndex;
     int32 LatentPropertyIndex;
+    int32 ReturnArgIndex;
+    int32 LatentArgIndex;
     uint8 bStaticFunc : 1;
     uint8 bInterfaceFunc : 1;
+    uint8 bNetFunc : 1;
+    uint8 bCheckCallspace : 1;
+    uint8 bNativeFastPath : 1;
+    uint8 bHasStructParams : 1;     // struct parameters passed by value, which may be passed as views
+    FNativeFuncPtr NativeFunc;
+    TArray<FProperty*> NativeOutProperties;
+    FDispatchCache DispatchCache;
     int32 ParmsSize;
     TUniquePtr<FTCHARToUTF8> LuaFunctionName;
 };
@@ -2,70 +2,104 @@
 
 #include "UnLuaPrivate.h"
 
-FParamBufferAllocator_Always::FParamBufferAllocator_Always(const UFunction& Func)
-{
-    check(Func.ParmsSize);
-    ParmsSize = Func.ParmsSize;
-}
+static constexpr int32 ParamBufferAlignment = 16;
+static constexpr int32 MinBlockSize = 16 * 1024;
 
-void* FParamBufferAllocator_Always::Get()
-{
-    const auto Ret = FMemory::Malloc(ParmsSize, 16);
-    FMemory::Memzero(Ret, ParmsSize);
-    return Ret;
-}
+SIZE_T FParamBufferArena::MaxHighWaterMark = 0;
 
-void FParamBufferAllocator_Always::Pop(void* Memory)
+FParamBufferArena::~FParamBufferArena()
 {
-    FMemory::Free(Memory);
+    for (const auto& Block : Blocks)
+    {
+        UNLUA_STAT_MEMORY_FREE(Block.Data, ParamBufferArena);
+        FMemory::Free(Block.Data);
+    }
 }
 
-FParamBufferAllocator_Persistent::FParamBufferAllocator_Persistent(const UFunction& Func)
-    : Counter(0)
+void* FParamBufferArena::Push(int32 Size)
 {
-    ParmsSize = Func.ParmsSize;
-}
+    check(Size > 0);
+    Size = Align(Size, ParamBufferAlignment);
 
-FParamBufferAllocator_Persistent::~FParamBufferAllocator_Persistent()
-{
-    for (int i = 0; i < Buffers.Num(); ++i)
+    while (Current < Blocks.Num())
     {
-        UNLUA_STAT_MEMORY_FREE(Buffers[i], PersistentParamBuffer);
-        FMemory::Free(Buffers[i]);
+        auto& Block = Blocks[Current];
+        if (Block.Top + Size <= Block.Size)
+            break;
+        if (Block.Top > 0)
+        {
+            ++Current;
+            continue;
+        }
+
+        // an empty block which is too small for this frame, replace it
+        UNLUA_STAT_MEMORY_FREE(Block.Data, ParamBufferArena);
+        FMemory::Free(Block.Data);
+        Blocks.RemoveAt(Current);
     }
-}
 
-void* FParamBufferAllocator_Persistent::Get()
-{
-    if (Counter < Buffers.Num())
-        return Buffers[Counter++];
+    if (Current == Blocks.Num())
+    {
+        FBlock& Block = Blocks.AddDefaulted_GetRef();
+        Block.Size = FMath::Max(MinBlockSize, Size);
+        Block.Data = (uint8*)FMemory::Malloc(Block.Size, ParamBufferAlignment);
+        Block.Top = 0;
+        UNLUA_STAT_MEMORY_ALLOC(Block.Data, ParamBufferArena);
+    }
 
-    Counter++;
-    const auto Buffer = FMemory::Malloc(ParmsSize, 16);
-    FMemory::Memzero(Buffer, ParmsSize);
-    UNLUA_STAT_MEMORY_ALLOC(Buffer, PersistentParamBuffer);
-    Buffers.Add(Buffer);
-    return Buffer;
+    auto& Block = Blocks[Current];
+    const auto Ret = Block.Data + Block.Top;
+    Block.Top += Size;
+    Used += Size;
+    if (Used > HighWaterMark)
+    {
+        HighWaterMark = Used;
+        if (HighWaterMark > MaxHighWaterMark)
+        {
+            MaxHighWaterMark = HighWaterMark;
+            UNLUA_STAT_MEMORY_SET(MaxHighWaterMark, ParamBufferArenaHighWater);
+        }
+    }
+    return Ret;
 }
 
-void FParamBufferAllocator_Persistent::Pop(void* Memory)
+void FParamBufferArena::RestoreSlow(const FMark& Mark)
 {
-    check(Counter > 0);
-    Counter--;
-    check(Buffers[Counter] == Memory);
+    for (; Current > Mark.Block; --Current)
+    {
+        if (!Blocks.IsValidIndex(Current))
+            continue;
+        Used -= Blocks[Current].Top;
+        Blocks[Current].Top = 0;
+    }
+
+    // the block of the mark may have been replaced if it was empty, its top is 0 then
+    if (Blocks.IsValidIndex(Current) && Blocks[Current].Top > Mark.Top)
+    {
+        Used -= Blocks[Current].Top - Mark.Top;
+        Blocks[Current].Top = Mark.Top;
+    }
 }
 
-TSharedRef<FParamBufferAllocator> FParamBufferFactory::Get(const UFunction& Func)
+void FParamBufferArena::Pop(void* Memory)
 {
-    if (Func.ParmsSize == 0)
+    const auto Ptr = (uint8*)Memory;
+    for (; Current >= 0; --Current)
     {
-        static FParamBufferAllocator_Empty Empty;
-        return MakeShared<FParamBufferAllocator_Empty>(Empty);
-    }
+        auto& Block = Blocks[Current];
+        if (Ptr >= Block.Data && Ptr < Block.Data + Block.Size)
+        {
+            const int32 NewTop = Ptr - Block.Data;
+            check(NewTop < Block.Top);
+            Used -= Block.Top - NewTop;
+            Block.Top = NewTop;
+            return;
+        }
 
-#if ENABLE_PERSISTENT_PARAM_BUFFER
-    return MakeShareable(new FParamBufferAllocator_Persistent(Func));
-#else
-    return MakeShareable(new FParamBufferAllocator_Always(Func));
-#endif
+        // release frames leaked by an error above the popped one
+        Used -= Block.Top;
+        Block.Top = 0;
+    }
+    checkf(false, TEXT("parameter buffer doesn't belong to this arena"));
+    Current = 0;
 }
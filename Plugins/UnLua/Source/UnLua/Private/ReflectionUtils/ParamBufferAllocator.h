@@ -14,61 +14,69 @@
 
 #pragma once
 
-class FParamBufferAllocator
+/**
+ * Parameter frames no larger than this are allocated on the native stack of the caller
+ */
+#define UNLUA_MAX_STACK_PARAM_BUFFER_SIZE 256
+
+/**
+ * Per-env bump-pointer arena for parameter frames.
+ *
+ * Frames must be released in LIFO order. This holds for nested Lua<->UE calls since every frame is
+ * popped before its call returns, and a coroutine can't yield across a UFunction call. Popping a frame
+ * also releases any frame above it, so frames leaked by a Lua error are reclaimed by the outer caller.
+ */
+class FParamBufferArena
 {
 public:
-    virtual ~FParamBufferAllocator() = default;
+    FParamBufferArena() = default;
 
-    virtual void* Get() = 0;
+    ~FParamBufferArena();
 
-    virtual void Pop(void* Memory) = 0;
-};
+    void* Push(int32 Size);
 
-class FParamBufferAllocator_Empty : public FParamBufferAllocator
-{
-public:
-    virtual void* Get() override
+    void Pop(void* Memory);
+
+    /**
+     * Position of the arena top, saved before calling into Lua
+     */
+    struct FMark
     {
-        return nullptr;
-    }
+        int32 Block;
+        int32 Top;
+        SIZE_T Used;
+    };
 
-    virtual void Pop(void* Memory) override
+    FORCEINLINE FMark GetMark() const
     {
+        return {Current, Blocks.IsValidIndex(Current) ? Blocks[Current].Top : 0, Used};
     }
-};
-
-class FParamBufferAllocator_Always : public FParamBufferAllocator
-{
-public:
-    explicit FParamBufferAllocator_Always(const UFunction& Func);
-
-    virtual void* Get() override;
-
-    virtual void Pop(void* Memory) override;
-
-private:
-    uint16 ParmsSize;
-};
-
-class FParamBufferAllocator_Persistent : public FParamBufferAllocator
-{
-public:
-    explicit FParamBufferAllocator_Persistent(const UFunction& Func);
-
-    virtual ~FParamBufferAllocator_Persistent() override;
 
-    virtual void* Get() override;
+    /**
+     * Release the frames pushed after the mark, frames leaked by an error at the outermost level have no outer
+     * frame to release them
+     */
+    FORCEINLINE void Restore(const FMark& Mark)
+    {
+        if (Used != Mark.Used)
+            RestoreSlow(Mark);
+    }
 
-    virtual void Pop(void* Memory) override;
+    FORCEINLINE SIZE_T GetHighWaterMark() const { return HighWaterMark; }
 
 private:
-    uint8 Counter;
-    uint16 ParmsSize;
-    TArray<void*> Buffers;
-};
+    void RestoreSlow(const FMark& Mark);
 
-class FParamBufferFactory
-{
-public:
-    static TSharedRef<FParamBufferAllocator> Get(const UFunction& Func);
+    struct FBlock
+    {
+        uint8* Data;
+        int32 Size;
+        int32 Top;
+    };
+
+    TArray<FBlock> Blocks;
+    int32 Current = 0;
+    SIZE_T Used = 0;
+    SIZE_T HighWaterMark = 0;
+    static SIZE_T MaxHighWaterMark; // the largest high water mark of all arenas, which the stat reports
 };
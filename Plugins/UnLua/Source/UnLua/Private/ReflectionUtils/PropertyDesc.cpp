@@ -20,6 +20,206 @@
 #include "Containers/LuaSet.h"
 #include "Containers/LuaMap.h"
 #include "ObjectReferencer.h"
+#include "Misc/EngineVersionComparison.h"
+
+uint32 FPropertyAccessor::LayoutGeneration = 1;
+
+static int32 FPropertyAccessor_GC(lua_State *L)
+{
+    const auto Accessor = (FPropertyAccessor*)lua_touserdata(L, 1);
+    Accessor->~FPropertyAccessor();
+    return 0;
+}
+
+namespace PropertyAccessors
+{
+    static void ReadGeneric(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr)
+    {
+        Accessor.Desc->GetValue(L, (const uint8*)ContainerPtr + Accessor.Offset, false);
+    }
+
+    static void WriteGeneric(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack)
+    {
+        Accessor.Desc->SetValue(L, (uint8*)ContainerPtr + Accessor.Offset, IndexInStack, true);
+    }
+
+    static void ReadExported(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr)
+    {
+        Accessor.Ops->ReadValue_InContainer(L, ContainerPtr, false);
+    }
+
+    static void WriteExported(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack)
+    {
+        Accessor.Ops->WriteValue_InContainer(L, ContainerPtr, IndexInStack);
+    }
+
+    static void ReadInt32(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr)
+    {
+        lua_pushinteger(L, *(const int32*)((const uint8*)ContainerPtr + Accessor.Offset));
+    }
+
+    static void WriteInt32(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack)
+    {
+        *(int32*)((uint8*)ContainerPtr + Accessor.Offset) = (int32)lua_tointeger(L, IndexInStack);
+    }
+
+    static void ReadFloat(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr)
+    {
+        lua_pushnumber(L, *(const float*)((const uint8*)ContainerPtr + Accessor.Offset));
+    }
+
+    static void WriteFloat(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack)
+    {
+        *(float*)((uint8*)ContainerPtr + Accessor.Offset) = (float)lua_tonumber(L, IndexInStack);
+    }
+
+    static void ReadDouble(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr)
+    {
+        lua_pushnumber(L, *(const double*)((const uint8*)ContainerPtr + Accessor.Offset));
+    }
+
+    static void WriteDouble(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack)
+    {
+        *(double*)((uint8*)ContainerPtr + Accessor.Offset) = (double)lua_tonumber(L, IndexInStack);
+    }
+
+    static void ReadBool(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr)
+    {
+        lua_pushboolean(L, *(const bool*)((const uint8*)ContainerPtr + Accessor.Offset));
+    }
+
+    static void WriteBool(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack)
+    {
+        *(bool*)((uint8*)ContainerPtr + Accessor.Offset) = lua_toboolean(L, IndexInStack) != 0;
+    }
+
+    static void ReadBitfield(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr)
+    {
+        lua_pushboolean(L, (*((const uint8*)ContainerPtr + Accessor.Offset) & Accessor.ByteMask) != 0);
+    }
+
+    static void WriteBitfield(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack)
+    {
+        uint8& Byte = *((uint8*)ContainerPtr + Accessor.Offset);
+        Byte = lua_toboolean(L, IndexInStack) ? (Byte | Accessor.ByteMask) : (Byte & ~Accessor.ByteMask);
+    }
+
+    static void ReadObject(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr)
+    {
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+        UnLua::PushUObject(L, *(UObject* const*)((const uint8*)ContainerPtr + Accessor.Offset));
+#else
+        UnLua::PushUObject(L, ((const TObjectPtr<UObject>*)((const uint8*)ContainerPtr + Accessor.Offset))->Get());
+#endif
+    }
+
+    static void WriteObject(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack)
+    {
+        auto Object = UnLua::GetUObject(L, IndexInStack, false);
+        if (UnLua::LowLevel::IsReleasedPtr(Object))
+        {
+            UNLUA_LOGWARNING(L, LogUnLua, Warning, TEXT("attempt to set property %s with released object"), *Accessor.GetName());
+            Object = nullptr;
+        }
+#if ENABLE_TYPE_CHECK == 1
+        const auto PropertyClass = ((FObjectProperty*)Accessor.Desc->GetProperty())->PropertyClass;
+        if (Object && !Object->GetClass()->IsChildOf(PropertyClass))
+            UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("Invalid value type : property.type=%s, value.type=%s"), *PropertyClass->GetName(), *Object->GetClass()->GetName());
+#endif
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+        *(UObject**)((uint8*)ContainerPtr + Accessor.Offset) = Object;
+#else
+        *(TObjectPtr<UObject>*)((uint8*)ContainerPtr + Accessor.Offset) = Object;
+#endif
+    }
+}
+
+void FPropertyAccessor::SelectAccessFunctions(const FProperty *Property)
+{
+    using namespace PropertyAccessors;
+
+    Reader = ReadGeneric;
+    Writer = WriteGeneric;
+    if (Property->ArrayDim != 1)
+        return;
+
+    if (Property->IsA<FIntProperty>())
+    {
+        Reader = ReadInt32;
+        Writer = WriteInt32;
+    }
+    else if (Property->IsA<FFloatProperty>())
+    {
+        Reader = ReadFloat;
+        Writer = WriteFloat;
+    }
+    else if (Property->IsA<FDoubleProperty>())
+    {
+        Reader = ReadDouble;
+        Writer = WriteDouble;
+    }
+    else if (const auto BoolProperty = CastField<FBoolProperty>(Property))
+    {
+        if (BoolProperty->IsNativeBool())
+        {
+            Reader = ReadBool;
+            Writer = WriteBool;
+        }
+        else
+        {
+            Offset += BoolProperty->GetByteOffset();
+            ByteMask = BoolProperty->GetByteMask();
+            Reader = ReadBitfield;
+            Writer = WriteBitfield;
+        }
+    }
+    else if (Property->GetClass() == FObjectProperty::StaticClass())
+    {
+        // class properties check their meta class, soft/weak/lazy pointers have their own layout
+        Reader = ReadObject;
+        Writer = WriteObject;
+    }
+}
+
+void FPropertyAccessor::Push(lua_State *L, const TSharedPtr<UnLua::ITypeOps> &Property)
+{
+    const auto Accessor = new(lua_newuserdata(L, sizeof(FPropertyAccessor))) FPropertyAccessor();
+    if (luaL_newmetatable(L, "FPropertyAccessor"))
+    {
+        lua_pushcfunction(L, FPropertyAccessor_GC);
+        lua_setfield(L, -2, "__gc");
+    }
+    lua_setmetatable(L, -2);
+
+    Accessor->Owner = Property;
+    Accessor->Ops = Property.Get();
+    Accessor->Desc = Property->StaticExported ? nullptr : static_cast<FPropertyDesc*>(Property.Get());
+    Accessor->OwnerClass = nullptr;
+    Accessor->Offset = 0;
+    Accessor->Size = 0;
+    Accessor->Generation = 0;
+    Accessor->ByteMask = 0;
+    Accessor->Reader = PropertyAccessors::ReadExported;
+    Accessor->Writer = PropertyAccessors::WriteExported;
+    Accessor->Refresh();
+}
+
+bool FPropertyAccessor::Refresh()
+{
+    if (Desc)
+    {
+        if (!Desc->IsValid())
+            return false;
+
+        const FProperty* Property = Desc->GetProperty();
+        OwnerClass = Property->GetOwnerClass();
+        Offset = Property->GetOffset_ForInternal();
+        Size = Property->GetSize();
+        SelectAccessFunctions(Property);
+    }
+    Generation = LayoutGeneration;
+    return true;
+}
 
 FPropertyDesc::FPropertyDesc(FProperty *InProperty) : Property(InProperty) 
 {
@@ -598,13 +798,13 @@ public:
         }
         else
         {
-            lua_pushstring(L, TCHAR_TO_UTF8(*NameProperty->GetPropertyValue(ValuePtr).ToString()));
+            UnLua::FLuaEnv::FindEnvChecked(L).GetNameCache()->Push(L, NameProperty->GetPropertyValue(ValuePtr));
         }
     }
 
     virtual bool SetValueInternal(lua_State *L, void *ValuePtr, int32 IndexInStack, bool bCopyValue) const override
     {
-        NameProperty->SetPropertyValue(ValuePtr, FName(UTF8_TO_TCHAR(lua_tostring(L, IndexInStack))));
+        NameProperty->SetPropertyValue(ValuePtr, UnLua::FLuaEnv::FindEnvChecked(L).GetNameCache()->ToName(L, IndexInStack));
         return true;
     }
 
@@ -736,7 +936,25 @@ class FArrayPropertyDesc : public FPropertyDesc, public TLuaContainerInterface<F
 public:
     explicit FArrayPropertyDesc(FProperty *InProperty)
         : FPropertyDesc(InProperty), InnerProperty(FPropertyDesc::Create(ArrayProperty->Inner))
-    {}
+    {
+        const FProperty* Inner = ArrayProperty->Inner;
+        if (Inner->IsA<FIntProperty>())
+            ElementKind = EElementKind::Int32;
+        else if (Inner->IsA<FFloatProperty>())
+            ElementKind = EElementKind::Float;
+        else if (Inner->IsA<FDoubleProperty>())
+            ElementKind = EElementKind::Double;
+        else if (Inner->IsA<FBoolProperty>())
+            ElementKind = EElementKind::Bool;
+        else if (Inner->IsA<FNameProperty>())
+            ElementKind = EElementKind::Name;
+        else if (Inner->GetClass() == FObjectProperty::StaticClass())
+            ElementKind = EElementKind::Object;
+        else if (Inner->IsA<FStructProperty>() && ((const FStructProperty*)Inner)->Struct == TBaseStructure<FVector>::Get())
+            ElementKind = EElementKind::Vector;
+        else
+            ElementKind = EElementKind::Generic;
+    }
 
     virtual bool CopyBack(lua_State *L, int32 SrcIndexInStack, void *DestContainerPtr) override
     {
@@ -783,10 +1001,13 @@ public:
         int32 Type = lua_type(L, IndexInStack);
         if (Type == LUA_TTABLE)
         {
-            FScriptArray ScriptArray;
-            FLuaArray LuaArray(&ScriptArray, InnerProperty, FLuaArray::OwnedByOther);
-            TraverseTable(L, IndexInStack, &LuaArray, FArrayPropertyDesc::FillArray);       // fill table elements
-            ArrayProperty->CopyCompleteValue(ValuePtr, &ScriptArray);
+            if (!SetSequence(L, ValuePtr, lua_absindex(L, IndexInStack)))
+            {
+                FScriptArray ScriptArray;
+                FLuaArray LuaArray(&ScriptArray, InnerProperty, FLuaArray::OwnedByOther);
+                TraverseTable(L, IndexInStack, &LuaArray, FArrayPropertyDesc::FillArray);       // fill table elements
+                ArrayProperty->CopyCompleteValue(ValuePtr, &ScriptArray);
+            }
         }
         else if (Type == LUA_TUSERDATA)
         {
@@ -876,7 +1097,141 @@ public:
     }
 
 private:
+    enum class EElementKind : uint8
+    {
+        Generic,
+        Int32,
+        Float,
+        Double,
+        Bool,
+        Name,
+        Object,
+        Vector,
+    };
+
+    /**
+     * Convert a sequence table with 'lua_rawgeti', element types without aliasing are written into the destination array directly
+     *
+     * @return - false if the table is not a non-empty sequence
+     */
+    bool SetSequence(lua_State *L, void *ValuePtr, int32 TableIndex) const
+    {
+        const int32 Num = (int32)lua_rawlen(L, TableIndex);
+        if (Num <= 0)
+            return false;
+
+        // any key after the border means it's not a plain sequence
+        lua_pushinteger(L, Num);
+        if (lua_next(L, TableIndex) != 0)
+        {
+            lua_pop(L, 2);
+            return false;
+        }
+
+        if (ElementKind == EElementKind::Generic || ElementKind == EElementKind::Vector)
+        {
+            // elements may be views into the destination array, build a new one and swap it in
+            FScriptArray ScriptArray;
+            FScriptArrayHelper Helper(ArrayProperty, &ScriptArray);
+            if (ElementKind == EElementKind::Vector)
+            {
+                Helper.AddUninitializedValues(Num);
+                FVector* Data = (FVector*)Helper.GetRawPtr(0);
+                for (int32 i = 0; i < Num; ++i)
+                {
+                    lua_rawgeti(L, TableIndex, i + 1);
+                    const FVector* Value = (const FVector*)GetCppInstanceFast(L, -1);
+                    Data[i] = Value ? *Value : FVector::ZeroVector;
+                    lua_pop(L, 1);
+                }
+            }
+            else
+            {
+                Helper.AddValues(Num);
+                for (int32 i = 0; i < Num; ++i)
+                {
+                    lua_rawgeti(L, TableIndex, i + 1);
+                    InnerProperty->WriteValue_InContainer(L, Helper.GetRawPtr(i), -1);
+                    lua_pop(L, 1);
+                }
+            }
+            FMemory::Memswap(ValuePtr, &ScriptArray, sizeof(FScriptArray));
+            Helper.EmptyValues();
+            return true;
+        }
+
+        FScriptArrayHelper Helper(ArrayProperty, ValuePtr);
+        Helper.EmptyAndAddValues(Num);
+        uint8* Data = Helper.GetRawPtr(0);
+        switch (ElementKind)
+        {
+        case EElementKind::Int32:
+            for (int32 i = 0; i < Num; ++i)
+            {
+                lua_rawgeti(L, TableIndex, i + 1);
+                ((int32*)Data)[i] = (int32)lua_tointeger(L, -1);
+                lua_pop(L, 1);
+            }
+            break;
+        case EElementKind::Float:
+            for (int32 i = 0; i < Num; ++i)
+            {
+                lua_rawgeti(L, TableIndex, i + 1);
+                ((float*)Data)[i] = (float)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+            }
+            break;
+        case EElementKind::Double:
+            for (int32 i = 0; i < Num; ++i)
+            {
+                lua_rawgeti(L, TableIndex, i + 1);
+                ((double*)Data)[i] = (double)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+            }
+            break;
+        case EElementKind::Bool:
+            for (int32 i = 0; i < Num; ++i)
+            {
+                lua_rawgeti(L, TableIndex, i + 1);
+                ((bool*)Data)[i] = lua_toboolean(L, -1) != 0;
+                lua_pop(L, 1);
+            }
+            break;
+        case EElementKind::Name:
+            {
+                const auto NameCache = UnLua::FLuaEnv::FindEnvChecked(L).GetNameCache();
+                for (int32 i = 0; i < Num; ++i)
+                {
+                    lua_rawgeti(L, TableIndex, i + 1);
+                    ((FName*)Data)[i] = NameCache->ToName(L, -1);
+                    lua_pop(L, 1);
+                }
+            }
+            break;
+        case EElementKind::Object:
+            {
+                const auto ObjectProperty = (FObjectProperty*)ArrayProperty->Inner;
+                const int32 Stride = ObjectProperty->ElementSize;
+                for (int32 i = 0; i < Num; ++i)
+                {
+                    lua_rawgeti(L, TableIndex, i + 1);
+                    auto Object = UnLua::GetUObject(L, -1, false);
+                    if (UnLua::LowLevel::IsReleasedPtr(Object))
+                        Object = nullptr;
+                    ObjectProperty->SetObjectPropertyValue(Data + i * Stride, Object);
+                    lua_pop(L, 1);
+                }
+            }
+            break;
+        default:
+            check(false);
+            break;
+        }
+        return true;
+    }
+
     TSharedPtr<UnLua::ITypeInterface> InnerProperty;
+    EElementKind ElementKind;
 };
 
 
@@ -1216,6 +1571,18 @@ public:
         return false;
     }
 
+    virtual void ReadValueView_InContainer(lua_State *L, const void *ContainerPtr) const override
+    {
+        if (Property->ArrayDim > 1 || !PropertyPtr.IsValid())
+        {
+            ReadValue_InContainer(L, ContainerPtr, true);
+            return;
+        }
+
+        void* ValuePtr = Property->ContainerPtrToValuePtr<void>((void*)ContainerPtr);
+        UnLua::FLuaEnv::FindEnvChecked(L).GetDanglingCheck()->PushStructView(L, ValuePtr, StructName.Get());
+    }
+
     virtual void GetValueInternal(lua_State *L, const void *ValuePtr, bool bCreateCopy) const override
     {
         if (bCreateCopy)
@@ -184,6 +184,11 @@ public:
         GetValueInternal(L, ValuePtr, bCreateCopy);
     }
 
+    /**
+     * Read the value of a parameter as a borrowed view if possible, it is valid until the call into Lua returns
+     */
+    virtual void ReadValueView_InContainer(lua_State *L, const void *ContainerPtr) const { ReadValue_InContainer(L, ContainerPtr, true); }
+
     virtual bool WriteValue_InContainer(lua_State *L, void *ContainerPtr, int32 IndexInStack, bool bCreateCopy) const override 
     {
         if (UNLIKELY(!PropertyPtr.IsValid()))
@@ -224,6 +229,16 @@ public:
     virtual bool CheckPropertyType(lua_State* L, int32 IndexInStack, FString& ErrorMsg, void* UserData = nullptr) { return true; };
 #endif
 
+    /**
+     * Read the value without validating the property, the caller is responsible for it
+     */
+    FORCEINLINE void GetValue(lua_State *L, const void *ValuePtr, bool bCreateCopy) const { GetValueInternal(L, ValuePtr, bCreateCopy); }
+
+    /**
+     * Write the value without validating the property, the caller is responsible for it
+     */
+    FORCEINLINE bool SetValue(lua_State *L, void *ValuePtr, int32 IndexInStack, bool bCopyValue) const { return SetValueInternal(L, ValuePtr, IndexInStack, bCopyValue); }
+
     void SetPropertyType(int8 Type);
     int8 GetPropertyType();
 	
@@ -259,3 +274,88 @@ protected:
 };
 
 UNLUA_API int32 GetPropertyType(const FProperty *Property);
+
+/**
+ * Compact accessor of a property cached in metatables
+ *
+ * The layout of the property is captured at creation and revalidated only when a reflected type known to Lua
+ * has been unloaded since, so reads and writes skip the weak pointer and refcount traffic of the descriptor.
+ */
+struct FPropertyAccessor
+{
+    /**
+     * Push a new accessor of the property
+     */
+    static void Push(lua_State *L, const TSharedPtr<UnLua::ITypeOps> &Property);
+
+    /**
+     * Get the accessor at the given stack index, nullptr if it is not an accessor
+     */
+    static FORCEINLINE FPropertyAccessor* Get(lua_State *L, int32 Index)
+    {
+        return lua_type(L, Index) == LUA_TUSERDATA ? (FPropertyAccessor*)lua_touserdata(L, Index) : nullptr;
+    }
+
+    /**
+     * Test if the captured layout is up to date, it is refreshed if possible
+     */
+    FORCEINLINE bool IsValid()
+    {
+#if WITH_EDITOR
+        // user defined structs are recompiled in place in editor
+        if (Desc && !Desc->IsValid())
+            return false;
+#endif
+        return Generation == LayoutGeneration || Refresh();
+    }
+
+    /**
+     * Test if the property can be accessed on the object
+     */
+    FORCEINLINE bool CheckOwner(lua_State *L, void *ContainerPtr) const
+    {
+#if ENABLE_TYPE_CHECK == 1
+        if (!OwnerClass || ((UObject*)ContainerPtr)->IsA(OwnerClass))
+            return true;
+        luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("Access property from invalid owner. %s should be a %s."), *((UObject*)ContainerPtr)->GetName(), *OwnerClass->GetName())));
+        return false;
+#else
+        return true;
+#endif
+    }
+
+    FORCEINLINE void Read(lua_State *L, const void *ContainerPtr) const { Reader(L, *this, ContainerPtr); }
+
+    FORCEINLINE void Write(lua_State *L, void *ContainerPtr, int32 IndexInStack) const { Writer(L, *this, ContainerPtr, IndexInStack); }
+
+    FORCEINLINE FString GetName() const { return Ops->GetName(); }
+
+    /**
+     * Invalidate the layouts captured by all accessors
+     */
+    static FORCEINLINE void NotifyLayoutChanged() { ++LayoutGeneration; }
+
+    TSharedPtr<UnLua::ITypeOps> Owner;  // keeps the descriptor alive, never touched on the hot path
+    UnLua::ITypeOps* Ops;
+    FPropertyDesc* Desc;                // nullptr for statically exported properties
+    UClass* OwnerClass;
+    int32 Offset;
+    int32 Size;
+    uint32 Generation;
+    uint8 ByteMask;                     // for bitfield bools
+
+    /**
+     * Readers and writers specialized for the most common kinds of properties, selected with the layout
+     */
+    typedef void(*FReader)(lua_State *L, const FPropertyAccessor &Accessor, const void *ContainerPtr);
+    typedef void(*FWriter)(lua_State *L, const FPropertyAccessor &Accessor, void *ContainerPtr, int32 IndexInStack);
+    FReader Reader;
+    FWriter Writer;
+
+private:
+    bool Refresh();
+
+    void SelectAccessFunctions(const FProperty *Property);
+
+    static uint32 LayoutGeneration;
+};
@@ -20,6 +20,7 @@
 #include "LuaCore.h"
 #include "UELib.h"
 #include "ReflectionUtils/ClassDesc.h"
+#include "ReflectionUtils/PropertyDesc.h"
 
 extern int32 UObject_Identical(lua_State* L);
 extern int32 UObject_Delete(lua_State* L);
@@ -62,6 +63,7 @@ namespace UnLua
         if (Ret)
         {
             Classes.FindOrAdd(Ret->AsStruct(), Ret);
+            Env->AddKnownObject(Ret->AsStruct());
             return Ret;
         }
 
@@ -98,6 +100,7 @@ namespace UnLua
         if (Exists)
         {
             Classes.Add(Type, *Exists);
+            Env->AddKnownObject(Type);
             return *Exists;
         }
 
@@ -268,6 +271,7 @@ namespace UnLua
         if (!Desc)
             return;
         Classes.Remove(Class);
+        FPropertyAccessor::NotifyLayoutChanged();
         Desc->UnLoad();
         Unregister(Desc, true);
     }
@@ -306,6 +310,7 @@ namespace UnLua
 
         FClassDesc* ClassDesc = new FClassDesc(Env, Type, Name);
         Classes.Add(Type, ClassDesc);
+        Env->AddKnownObject(Type);
         Name2Classes.Add(FName(*Name), ClassDesc);
 
         return ClassDesc;
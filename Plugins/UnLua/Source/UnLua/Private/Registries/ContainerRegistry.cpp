@@ -24,11 +24,8 @@ namespace UnLua
     {
         // <FScriptArray, FLuaArray/FLuaMap/FLuaSet>
         const auto L = Env->GetMainState();
-        lua_pushstring(L, "ScriptContainerMap");
         LowLevel::CreateWeakValueTable(L);
-        lua_pushvalue(L, -1);
-        MapRef = luaL_ref(L, -1);
-        lua_rawset(L, LUA_REGISTRYINDEX);
+        MapRef = luaL_ref(L, LUA_REGISTRYINDEX);
     }
 
     FLuaArray* FContainerRegistry::NewArray(lua_State* L, TSharedPtr<ITypeInterface> ElementType, FLuaArray::EScriptArrayFlag Flag)
@@ -70,6 +70,7 @@ namespace UnLua
             Info.LuaRef = FuncRef;
             Info.Desc = TUniquePtr<FFunctionDesc>(FuncDesc);
             LuaFunctions.Add(Function, MoveTemp(Info));
+            Env->AddKnownObject(Function);
         }
 
         if (FuncRef == LUA_NOREF)
@@ -19,9 +19,6 @@
 
 namespace UnLua
 {
-    static const char* REGISTRY_KEY = "UnLua_ObjectMap";
-    static const char* MANUAL_REF_PROXY_MAP = "UnLua_ManualRefProxyMap";
-
     static int ReleaseSharedPtr(lua_State* L)
     {
         const auto Ptr = (TSharedPtr<void>*)lua_touserdata(L, 1);
@@ -37,7 +34,7 @@ namespace UnLua
         if (!Object)
             return 0;
 
-        lua_getfield(L, LUA_REGISTRYINDEX, MANUAL_REF_PROXY_MAP);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, Env.GetObjectRegistry()->GetManualRefProxyMapRef());
         lua_pushlightuserdata(L, Object);
         if (lua_rawget(L, -2) == LUA_TNIL)
             Env.RemoveManualObjectReference(Object);
@@ -49,13 +46,11 @@ namespace UnLua
     {
         const auto L = Env->GetMainState();
 
-        lua_pushstring(L, REGISTRY_KEY);
         LowLevel::CreateWeakValueTable(L);
-        lua_rawset(L, LUA_REGISTRYINDEX);
+        ObjectMapRef = luaL_ref(L, LUA_REGISTRYINDEX);
 
-        lua_pushstring(L, MANUAL_REF_PROXY_MAP);
         LowLevel::CreateWeakValueTable(L);
-        lua_rawset(L, LUA_REGISTRYINDEX);
+        ManualRefProxyMapRef = luaL_ref(L, LUA_REGISTRYINDEX);
         
         luaL_newmetatable(L, "TSharedPtr");
         lua_pushstring(L, "__gc");
@@ -95,7 +90,19 @@ namespace UnLua
             return;
         }
 
-        lua_getfield(L, LUA_REGISTRYINDEX, REGISTRY_KEY);
+        // 已绑定的对象直接通过引用ID取table，不经过弱表
+        const auto Slot = FindSlot(Object);
+        if (Slot && Slot->Ref != LUA_NOREF)
+        {
+            const int32 Ref = Slot->Ref == PendingRef ? Bind(Object) : Slot->Ref;
+            if (Ref != LUA_REFNIL)
+            {
+                lua_rawgeti(L, LUA_REGISTRYINDEX, Ref);
+                return;
+            }
+        }
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ObjectMapRef);
         lua_pushlightuserdata(L, Object);
         const auto Type = lua_rawget(L, -2);
         if (Type == LUA_TNIL)
@@ -105,25 +112,68 @@ namespace UnLua
             lua_pushlightuserdata(L, Object);
             lua_pushvalue(L, -2);
             lua_rawset(L, -4);
-            ObjectRefs.Add(Object, LUA_NOREF);
+            if (!Slot)
+                AddSlot(Object);
         }
         lua_remove(L, -2);
     }
 
-    int FObjectRegistry::Bind(UObject* Object)
+    bool FObjectRegistry::PushExisting(lua_State* L, UObject* Object)
+    {
+        const auto Slot = FindSlot(Object);
+        if (!Slot)
+            return false;
+
+        if (Slot->Ref != LUA_NOREF)
+        {
+            const int32 Ref = Slot->Ref == PendingRef ? Bind(Object) : Slot->Ref;
+            if (Ref != LUA_REFNIL)
+            {
+                lua_rawgeti(L, LUA_REGISTRYINDEX, Ref);
+                return true;
+            }
+        }
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ObjectMapRef);
+        lua_pushlightuserdata(L, Object);
+        if (lua_rawget(L, -2) == LUA_TNIL)
+        {
+            lua_pop(L, 2);
+            return false;
+        }
+        lua_remove(L, -2);
+        return true;
+    }
+
+    FObjectRegistry::FObjectSlot& FObjectRegistry::AddSlot(const UObject* Object)
     {
-        if (const auto Exists = ObjectRefs.Find(Object))
+        const int32 Index = GUObjectArray.ObjectToIndex(Object);
+        if (Index >= Slots.Num())
+            Slots.SetNumZeroed(Index + 1);
+
+        FObjectSlot& Slot = Slots[Index];
+        const int32 SerialNumber = GUObjectArray.AllocateSerialNumber(Index);
+        if (Slot.SerialNumber != SerialNumber)
         {
-            if (*Exists != LUA_NOREF)
-                return *Exists;
+            Slot.SerialNumber = SerialNumber;
+            Slot.Ref = LUA_NOREF;
+            Env->AddKnownObject(Object);
         }
+        return Slot;
+    }
+
+    int FObjectRegistry::Bind(UObject* Object)
+    {
+        const auto Exists = FindSlot(Object);
+        if (Exists && Exists->Ref != LUA_NOREF && Exists->Ref != PendingRef)
+            return Exists->Ref;
+        const bool bPushed = Exists != nullptr;
+        const bool bPending = bPushed && Exists->Ref == PendingRef;
 
         const auto L = Env->GetMainState();
 
         int OldTop = lua_gettop(L);
 
-        lua_getfield(L, LUA_REGISTRYINDEX, REGISTRY_KEY);
-        lua_pushlightuserdata(L, Object);
         lua_newtable(L); // create a Lua table ('INSTANCE')
         PushObjectCore(L, Object); // push UObject ('RAW_UOBJECT')
         lua_pushstring(L, "Object");
@@ -139,6 +189,8 @@ namespace UnLua
         if (TypeModule != LUA_TTABLE || TypeMetatable == LUA_TNIL)
         {
             lua_pop(L, lua_gettop(L) - OldTop);
+            if (bPending)
+                AddSlot(Object).Ref = LUA_NOREF;
             return LUA_REFNIL;
         }
 
@@ -153,41 +205,68 @@ namespace UnLua
 
         lua_pushvalue(L, -1);
         const auto Ret = luaL_ref(L, LUA_REGISTRYINDEX);
-        ObjectRefs.Add(Object, Ret);
+        AddSlot(Object).Ref = Ret;
 
         FUnLuaDelegates::OnObjectBinded.Broadcast(Object); // 'INSTANCE' is on the top of stack now
 
-        lua_rawset(L, -3);
         lua_pop(L, 1);
+
+        // 绑定后由引用ID持有table，弱表里之前压入的userdata不再使用
+        if (bPushed)
+        {
+            lua_rawgeti(L, LUA_REGISTRYINDEX, ObjectMapRef);
+            lua_pushlightuserdata(L, Object);
+            lua_pushnil(L);
+            lua_rawset(L, -3);
+            lua_pop(L, 1);
+        }
+
+        if (bPending)
+            Env->GetManager()->CallInitialize(Object);
         return Ret;
     }
 
+    void FObjectRegistry::BindLazily(UObject* Object)
+    {
+        auto& Slot = AddSlot(Object);
+        if (Slot.Ref == LUA_NOREF)
+            Slot.Ref = PendingRef;
+    }
+
     bool FObjectRegistry::IsBound(const UObject* Object) const
     {
-        const auto Exists = ObjectRefs.Find(Object);
-        return Exists && *Exists != LUA_NOREF;
+        const auto Slot = FindSlot(Object);
+        return Slot && Slot->Ref != LUA_NOREF;
     }
 
-    int FObjectRegistry::GetBoundRef(const UObject* Object) const
+    int FObjectRegistry::GetBoundRef(const UObject* Object)
     {
-        const auto Ref = ObjectRefs.Find(Object);
-        if (Ref)
-            return *Ref;
-        return LUA_NOREF;
+        const auto Slot = FindSlot(Object);
+        if (!Slot)
+            return LUA_NOREF;
+        if (Slot->Ref == PendingRef)
+        {
+            const int Ref = Bind(const_cast<UObject*>(Object));
+            return Ref == LUA_REFNIL ? LUA_NOREF : Ref;
+        }
+        return Slot->Ref;
     }
 
     void FObjectRegistry::Unbind(UObject* Object)
     {
-        int32 Ref;
-        if (!ObjectRefs.RemoveAndCopyValue(Object, Ref))
+        const auto Slot = FindSlot(Object);
+        if (!Slot)
             return;
 
+        const int32 Ref = Slot->Ref;
+        Slots[GUObjectArray.ObjectToIndex(Object)].SerialNumber = 0;
+
         const auto L = Env->GetMainState();
         const auto Top = lua_gettop(L);
-        RemoveFromObjectMapAndPushToStack(Object);
 
-        if (Ref == LUA_NOREF)
+        if (Ref == LUA_NOREF || Ref == PendingRef)
         {
+            RemoveFromObjectMapAndPushToStack(Object);
             if (lua_isnil(L, -1))
             {
                 lua_pop(L, 1);
@@ -202,6 +281,7 @@ namespace UnLua
             return;
         }
 
+        lua_rawgeti(L, LUA_REGISTRYINDEX, Ref);
         check(lua_istable(L, -1));
         luaL_unref(L, LUA_REGISTRYINDEX, Ref);
         FUnLuaDelegates::OnObjectUnbinded.Broadcast(Object); // object instance ('INSTANCE') is on the top of stack now
@@ -216,7 +296,7 @@ namespace UnLua
 
     void FObjectRegistry::AddManualRef(lua_State* L, UObject* Object)
     {
-        lua_getfield(L, LUA_REGISTRYINDEX, MANUAL_REF_PROXY_MAP);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ManualRefProxyMapRef);
         lua_pushlightuserdata(L, Object);
         if (lua_rawget(L, -2) == LUA_TNIL)
         {
@@ -237,7 +317,7 @@ namespace UnLua
     void FObjectRegistry::RemoveManualRef(UObject* Object)
     {
         const auto L = Env->GetMainState();
-        lua_getfield(L, LUA_REGISTRYINDEX, MANUAL_REF_PROXY_MAP);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ManualRefProxyMapRef);
         lua_pushlightuserdata(L, Object);
         lua_pushnil(L);
         lua_rawset(L, -3);
@@ -248,7 +328,7 @@ namespace UnLua
     void FObjectRegistry::RemoveFromObjectMapAndPushToStack(UObject* Object)
     {
         const auto L = Env->GetMainState();
-        lua_getfield(L, LUA_REGISTRYINDEX, REGISTRY_KEY);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ObjectMapRef);
         lua_pushlightuserdata(L, Object);
         lua_rawget(L, -2);
         lua_pushlightuserdata(L, Object);
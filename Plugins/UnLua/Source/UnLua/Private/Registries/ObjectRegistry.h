@@ -15,6 +15,7 @@
 #pragma once
 
 #include "lua.hpp"
+#include "UObject/UObjectArray.h"
 #include "UnLuaBase.h"
 #include "ReflectionUtils/FunctionDesc.h"
 
@@ -41,6 +42,12 @@ namespace UnLua
 
         void Push(lua_State* L, UObject* Object);
 
+        /**
+         * 若UObject已经压入过Lua（或已绑定），则将对应的userdata/table压入栈顶
+         * @return 是否找到
+         */
+        bool PushExisting(lua_State* L, UObject* Object);
+
         template <typename T>
         FORCEINLINE TSharedPtr<T> Get(lua_State* L, int Index);
 
@@ -51,15 +58,20 @@ namespace UnLua
         int Bind(UObject* Object);
 
         /**
-         * 获取一个值，表示UObject是否绑定到了Lua环境。
+         * 将一个UObject标记为已绑定，但推迟到Lua首次访问时才创建table并调用Initialize。
+         */
+        void BindLazily(UObject* Object);
+
+        /**
+         * 获取一个值，表示UObject是否绑定到了Lua环境，延迟绑定的对象也视为已绑定。
          */
         bool IsBound(const UObject* Object) const;
 
         /**
-         * 获取指定UObject在Lua里绑定的table的引用ID。
+         * 获取指定UObject在Lua里绑定的table的引用ID，延迟绑定的对象会在此时创建table。
          * @return 若没有绑定过则返回LUA_NOREF。
          */
-        int GetBoundRef(const UObject* Object) const;
+        int GetBoundRef(const UObject* Object);
 
         /**
          * 将指定的UObject从Lua环境解绑。
@@ -76,11 +88,42 @@ namespace UnLua
          */
         void RemoveManualRef(UObject* Object);
 
+        /**
+         * 获取手动引用代理弱表在注册表中的引用ID
+         */
+        FORCEINLINE int32 GetManualRefProxyMapRef() const { return ManualRefProxyMapRef; }
+
     private:
+        /**
+         * 以GUObjectArray索引定位的记录，序列号为0表示空位
+         */
+        struct FObjectSlot
+        {
+            int32 SerialNumber;
+            int32 Ref; // 绑定的table引用ID，仅压入过userdata时为LUA_NOREF，延迟绑定时为PendingRef
+        };
+
+        static constexpr int32 PendingRef = LUA_NOREF - 1;
+
+        FORCEINLINE const FObjectSlot* FindSlot(const UObject* Object) const
+        {
+            const int32 Index = GUObjectArray.ObjectToIndex(Object);
+            if (!Slots.IsValidIndex(Index))
+                return nullptr;
+            const FObjectSlot& Slot = Slots[Index];
+            if (Slot.SerialNumber == 0 || Slot.SerialNumber != GUObjectArray.IndexToObject(Index)->GetSerialNumber())
+                return nullptr;
+            return &Slot;
+        }
+
+        FObjectSlot& AddSlot(const UObject* Object);
+
         void RemoveFromObjectMapAndPushToStack(UObject* Object);
 
         FLuaEnv* Env;
-        TMap<UObject*, int32> ObjectRefs;
+        TArray<FObjectSlot> Slots;
+        int32 ObjectMapRef;
+        int32 ManualRefProxyMapRef;
     };
 
     template <typename T>
@@ -487,6 +487,7 @@ namespace UnLua
 
         const auto Ret = TSharedPtr<ITypeInterface>(FPropertyDesc::Create(Property));
         FieldProperties.Add(Field, Ret);
+        Env->AddKnownObject(Field);
         return Ret;
     }
 }
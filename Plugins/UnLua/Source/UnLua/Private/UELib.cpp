@@ -19,6 +19,8 @@
 #include "LuaDynamicBinding.h"
 #include "LuaEnv.h"
 #include "Registries/EnumRegistry.h"
+#include "ReflectionUtils/FieldDesc.h"
+#include "ReflectionUtils/FunctionDesc.h"
 
 static const char* REGISTRY_KEY = "UnLua_UELib";
 static const char* NAMESPACE_NAME = "UE";
@@ -135,6 +137,56 @@ static int32 Global_NewObject(lua_State *L)
     return 1;
 }
 
+/**
+ * Call a UFunction on each object of an array in one go.
+ * for example:
+ * local Results = UE.Batch.Call(Actors, "K2_SetActorLocation", Locations, false, nil, true)
+ * an argument of a plain table is passed per object, other arguments are passed to every object.
+ * returns a table with the results of each object.
+ */
+static int32 Batch_Call(lua_State* L)
+{
+    const int32 NumParams = lua_gettop(L);
+    if (NumParams < 2)
+        return luaL_error(L, "invalid parameters");
+
+    luaL_checktype(L, 1, LUA_TTABLE);
+    const char* FunctionName = luaL_checkstring(L, 2);
+
+    // the function is resolved on the class of the first valid object
+    UObject* FirstObject = nullptr;
+    const int32 NumObjects = (int32)lua_rawlen(L, 1);
+    for (int32 i = 1; i <= NumObjects && !FirstObject; ++i)
+    {
+        lua_rawgeti(L, 1, i);
+        FirstObject = UnLua::GetUObject(L, NumParams + 1);
+        lua_pop(L, 1);
+    }
+
+    if (!FirstObject)
+    {
+        lua_newtable(L);
+        return 1;
+    }
+
+    const auto& Env = UnLua::FLuaEnv::FindEnvChecked(L);
+    const auto ClassDesc = Env.GetClassRegistry()->Register(FirstObject->GetClass());
+    const auto Field = ClassDesc ? ClassDesc->RegisterField(FName(UTF8_TO_TCHAR(FunctionName)), ClassDesc) : nullptr;
+    if (!Field || !Field->IsFunction())
+        return luaL_error(L, "can't find UFunction '%s' on class '%s'", FunctionName, TCHAR_TO_UTF8(*FirstObject->GetClass()->GetName()));
+
+    const auto Function = Field->AsFunction();
+    if (!Function || !Function->IsValid())
+        return luaL_error(L, "invalid UFunction '%s'", FunctionName);
+
+    return Function->CallUEBatch(L, 1, 3, NumParams - 2);
+}
+
+static constexpr luaL_Reg UE_BatchFunctions[] = {
+    {"Call", Batch_Call},
+    {NULL, NULL}
+};
+
 static constexpr luaL_Reg UE_Functions[] = {
     {"LoadObject", UObject_Load},
     {"LoadClass", UClass_Load},
@@ -157,6 +209,11 @@ int UnLua::UELib::Open(lua_State* L)
     lua_rawset(L, LUA_REGISTRYINDEX);
 
     luaL_setfuncs(L, UE_Functions, 0);
+
+    lua_newtable(L);
+    luaL_setfuncs(L, UE_BatchFunctions, 0);
+    lua_setfield(L, -2, "Batch");
+
     lua_setglobal(L, NAMESPACE_NAME);
 
     // global access for legacy support
@@ -19,6 +19,7 @@
 #include "UnLuaModule.h"
 #include "Containers/LuaSet.h"
 #include "Containers/LuaMap.h"
+#include "ReflectionUtils/PropertyDesc.h"
 
 DEFINE_LOG_CATEGORY(LogUnLua);
 DEFINE_LOG_CATEGORY(UnLuaDelegate);
@@ -196,7 +197,7 @@ namespace UnLua
         if (!bAlwaysCreate)
         {
             // find the pointer from 'StructMap' first
-            lua_getfield(L, LUA_REGISTRYINDEX, "StructMap");
+            lua_rawgeti(L, LUA_REGISTRYINDEX, FLuaEnv::FindEnvChecked(L).GetStructMapRef());
             lua_pushlightuserdata(L, Value);
             int32 Type = lua_rawget(L, -2);
             if (Type == LUA_TUSERDATA)
@@ -338,6 +339,14 @@ namespace UnLua
         return Userdata;
     }
 
+    /**
+     * Push an accessor of a property to be cached in a metatable
+     */
+    void PushPropertyAccessor(lua_State *L, const TSharedPtr<ITypeOps> &Property)
+    {
+        FPropertyAccessor::Push(L, Property);
+    }
+
     /**
      * Allocate user data
      */
@@ -1,4 +1,6 @@
 ﻿#include "UnLuaConsoleCommands.h"
+#include "LuaCallProfiler.h"
+#include "LuaSampleProfiler.h"
 
 #define LOCTEXT_NAMESPACE "UnLuaConsoleCommands"
 
@@ -20,6 +22,16 @@ namespace UnLua
               *LOCTEXT("CommandText_CollectGarbage", "Force collect garbage in lua env.").ToString(),
               FConsoleCommandWithArgsDelegate::CreateRaw(this, &FUnLuaConsoleCommands::CollectGarbage)
           ),
+          ProfileCommand(
+              TEXT("lua.profile"),
+              *LOCTEXT("CommandText_Profile", "Profiles calls between lua and UFunctions. usage: lua.profile start|stop|dump [csv path]").ToString(),
+              FConsoleCommandWithArgsDelegate::CreateRaw(this, &FUnLuaConsoleCommands::Profile)
+          ),
+          SampleCommand(
+              TEXT("lua.sample"),
+              *LOCTEXT("CommandText_Sample", "Samples lua stacks to folded stacks for flame graphs. usage: lua.sample start [hz]|stop|dump [path]").ToString(),
+              FConsoleCommandWithArgsDelegate::CreateRaw(this, &FUnLuaConsoleCommands::Sample)
+          ),
           Module(InModule)
     {
     }
@@ -78,6 +90,78 @@ namespace UnLua
 
         Env->GC();
     }
+
+    void FUnLuaConsoleCommands::Profile(const TArray<FString>& Args) const
+    {
+        if (Args.Num() == 0)
+        {
+            UE_LOG(LogUnLua, Log, TEXT("usage: lua.profile start|stop|dump [csv path]"));
+            return;
+        }
+
+        if (Args[0] == TEXT("start"))
+        {
+            FCallProfiler::Start();
+            UE_LOG(LogUnLua, Log, TEXT("lua call profiling started."));
+        }
+        else if (Args[0] == TEXT("stop"))
+        {
+            FCallProfiler::Stop();
+            UE_LOG(LogUnLua, Log, TEXT("lua call profiling stopped."));
+        }
+        else if (Args[0] == TEXT("dump"))
+        {
+            const auto Path = FCallProfiler::Dump(Args.Num() > 1 ? Args[1] : FString());
+            if (Path.IsEmpty())
+                UE_LOG(LogUnLua, Log, TEXT("no lua call profile to dump."))
+            else
+                UE_LOG(LogUnLua, Log, TEXT("lua call profile saved to %s"), *Path);
+        }
+        else
+        {
+            UE_LOG(LogUnLua, Log, TEXT("usage: lua.profile start|stop|dump [csv path]"));
+        }
+    }
+
+    void FUnLuaConsoleCommands::Sample(const TArray<FString>& Args) const
+    {
+        if (Args.Num() == 0)
+        {
+            UE_LOG(LogUnLua, Log, TEXT("usage: lua.sample start [hz]|stop|dump [path]"));
+            return;
+        }
+
+        if (Args[0] == TEXT("start"))
+        {
+            auto Env = Module->GetEnv();
+            if (!Env)
+            {
+                UE_LOG(LogUnLua, Warning, TEXT("no available lua env found to sample."));
+                return;
+            }
+
+            const int32 Frequency = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000;
+            FSampleProfiler::Start(Env, Frequency);
+            UE_LOG(LogUnLua, Log, TEXT("lua sampling started at %dHz."), Frequency);
+        }
+        else if (Args[0] == TEXT("stop"))
+        {
+            FSampleProfiler::Stop();
+            UE_LOG(LogUnLua, Log, TEXT("lua sampling stopped."));
+        }
+        else if (Args[0] == TEXT("dump"))
+        {
+            const auto Path = FSampleProfiler::Dump(Args.Num() > 1 ? Args[1] : FString());
+            if (Path.IsEmpty())
+                UE_LOG(LogUnLua, Log, TEXT("no lua samples to dump."))
+            else
+                UE_LOG(LogUnLua, Log, TEXT("lua samples saved to %s"), *Path);
+        }
+        else
+        {
+            UE_LOG(LogUnLua, Log, TEXT("usage: lua.sample start [hz]|stop|dump [path]"));
+        }
+    }
 }
 
 #undef LOCTEXT_NAMESPACE
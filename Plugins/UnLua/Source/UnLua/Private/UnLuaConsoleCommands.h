@@ -27,6 +27,10 @@ namespace UnLua
 
         FAutoConsoleCommand CollectGarbageCommand;
 
+        FAutoConsoleCommand ProfileCommand;
+
+        FAutoConsoleCommand SampleCommand;
+
         explicit FUnLuaConsoleCommands(IUnLuaModule* InModule);
 
         void Do(const TArray<FString>& Args) const;
@@ -35,6 +39,10 @@ namespace UnLua
 
         void CollectGarbage(const TArray<FString>& Args) const;
 
+        void Profile(const TArray<FString>& Args) const;
+
+        void Sample(const TArray<FString>& Args) const;
+
     private:
         IUnLuaModule* Module;
     };
@@ -78,16 +78,17 @@ static int32 UUnLuaLatentAction_CreateInfo(lua_State* L)
         return 0;
     }
 
+    const auto Env = UnLua::FLuaEnv::FindEnv(L);
+    if (!Env)
+    {
+        UE_LOG(LogUnLua, Log, TEXT("%s: invalid L!"), ANSI_TO_TCHAR(__FUNCTION__));
+        return 0;
+    }
+
     int32 Linkage;
     if (NumParams <= 1)
     {
-        const auto Env = UnLua::FLuaEnv::FindEnv(L);
-        if (!Env)
-        {
-            UE_LOG(LogUnLua, Log, TEXT("%s: invalid L!"), ANSI_TO_TCHAR(__FUNCTION__));
-            return 0;
-        }
-        Linkage = Env->FindOrAddThread(L);
+        Linkage = Env->AddThread(L);
         if (Linkage == LUA_REFNIL)
         {
             luaL_error(L, "coroutine thread required");
@@ -102,7 +103,7 @@ static int32 UUnLuaLatentAction_CreateInfo(lua_State* L)
     }
 
     const auto UserData = NewUserdataWithPadding(L, sizeof(FLatentActionInfo), "FLatentActionInfo");
-    new(UserData) FLatentActionInfo(Linkage, GetTypeHash(FGuid::NewGuid()), TEXT("OnCompleted"), Self);
+    new(UserData) FLatentActionInfo(Linkage, Env->NewLatentUUID(), TEXT("OnCompleted"), Self);
     return 1;
 }
 
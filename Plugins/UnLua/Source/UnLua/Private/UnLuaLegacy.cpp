@@ -16,7 +16,8 @@
 #include "UnLuaPrivate.h"
 
 UNLUA_DEFINE_STAT(Lua_Memory);
-UNLUA_DEFINE_STAT(PersistentParamBuffer_Memory);
+UNLUA_DEFINE_STAT(ParamBufferArena_Memory);
+UNLUA_DEFINE_STAT(ParamBufferArenaHighWater_Memory);
 UNLUA_DEFINE_STAT(OutParmRec_Memory);
 UNLUA_DEFINE_STAT(ContainerElementCache_Memory);
 
@@ -1,7 +1,9 @@
 #include "UnLuaLib.h"
 #include "LowLevel.h"
+#include "LuaCore.h"
 #include "LuaEnv.h"
 #include "UnLuaBase.h"
+#include "ReflectionUtils/PropertyDesc.h"
 
 namespace UnLua
 {
@@ -50,6 +52,7 @@ namespace UnLua
 
         static int HotReload(lua_State* L)
         {
+            FLuaModuleResolver::InvalidateAll();
 #if UNLUA_WITH_HOT_RELOAD
             if (luaL_dostring(L, "require('UnLua.HotReload').reload()") != 0)
             {
@@ -81,6 +84,217 @@ namespace UnLua
             return 0;
         }
 
+        static int StartCoroutine(lua_State* L)
+        {
+            luaL_checktype(L, 1, LUA_TFUNCTION);
+
+            auto& Env = FLuaEnv::FindEnvChecked(L);
+            Env.StartCoroutine(L, lua_gettop(L) - 1);
+            return 0;
+        }
+
+#pragma region Bulk Property Access
+
+        /**
+         * A list of properties of a type resolved once, the accessors and the metatable of the type are anchored by the user values
+         */
+        struct FPropSet
+        {
+            TWeakObjectPtr<UStruct> Struct;
+            bool bIsClass;
+            UPTRINT Num;
+
+            FORCEINLINE FPropertyAccessor** GetAccessors() { return (FPropertyAccessor**)(this + 1); }
+        };
+
+        static void* CheckInstance(lua_State* L, int32 Index)
+        {
+            void* Self = GetCppInstance(L, Index);
+            if (!Self)
+                luaL_error(L, "invalid UObject or struct");
+            if (LowLevel::IsReleasedPtr(Self))
+                luaL_error(L, "attempt to access properties on released object");
+            return Self;
+        }
+
+        static FPropertyAccessor* CheckAccessor(lua_State* L, int32 Index, int32 KeyIndex)
+        {
+            const auto Accessor = FPropertyAccessor::Get(L, Index);
+            if (!Accessor)
+                luaL_error(L, "'%s' is not a property", lua_tostring(L, KeyIndex));
+            return Accessor;
+        }
+
+        static FORCEINLINE void ReadProperty(lua_State* L, FPropertyAccessor* Accessor, void* Self)
+        {
+            if (Accessor->IsValid() && Accessor->CheckOwner(L, Self))
+                Accessor->Read(L, Self);
+            else
+                lua_pushnil(L);
+        }
+
+        static FORCEINLINE void WriteProperty(lua_State* L, FPropertyAccessor* Accessor, void* Self, int32 IndexInStack)
+        {
+            if (Accessor->IsValid() && Accessor->CheckOwner(L, Self))
+                Accessor->Write(L, Self, IndexInStack);
+        }
+
+        static int GetProps(lua_State* L)
+        {
+            const int32 NumNames = lua_gettop(L) - 1;
+            void* Self = CheckInstance(L, 1);
+            if (!PushInstanceMetatable(L, 1))
+                return luaL_error(L, "invalid UObject or struct");
+
+            const int32 MetatableIndex = lua_gettop(L);
+            luaL_checkstack(L, NumNames + 2, nullptr);
+            for (int32 NameIndex = 2; NameIndex < MetatableIndex; ++NameIndex)
+            {
+                luaL_checktype(L, NameIndex, LUA_TSTRING);
+                PushMetatableField(L, MetatableIndex, NameIndex);
+                const auto Accessor = CheckAccessor(L, -1, NameIndex);
+                ReadProperty(L, Accessor, Self);
+                lua_remove(L, -2);
+            }
+            return NumNames;
+        }
+
+        static int SetProps(lua_State* L)
+        {
+            void* Self = CheckInstance(L, 1);
+            luaL_checktype(L, 2, LUA_TTABLE);
+            if (!PushInstanceMetatable(L, 1))
+                return luaL_error(L, "invalid UObject or struct");
+
+            const int32 MetatableIndex = lua_gettop(L);
+            lua_pushnil(L);
+            while (lua_next(L, 2) != 0)
+            {
+                if (lua_type(L, -2) != LUA_TSTRING)
+                    return luaL_error(L, "property name must be a string");
+
+                PushMetatableField(L, MetatableIndex, -2);
+                const auto Accessor = CheckAccessor(L, -1, -3);
+                WriteProperty(L, Accessor, Self, MetatableIndex + 2);
+                lua_pop(L, 2);
+            }
+            return 0;
+        }
+
+        /**
+         * The accessors of a PropSet are resolved for one type, reject instances of other types
+         */
+        static void* CheckPropSetInstance(lua_State* L, FPropSet* Set)
+        {
+            void* Self = CheckInstance(L, 2);
+            if (!PushInstanceMetatable(L, 2))
+                luaL_error(L, "invalid UObject or struct");
+
+            lua_getiuservalue(L, 1, 2);
+            const bool bSameType = lua_rawequal(L, -1, -2) != 0;
+            lua_pop(L, 1);
+            if (!bSameType)
+            {
+                // objects of derived classes are accepted
+                lua_pushstring(L, "ClassDesc");
+                lua_rawget(L, -2);
+                const auto ClassDesc = (FClassDesc*)lua_touserdata(L, -1);
+                lua_pop(L, 1);
+
+                const auto Struct = Set->Struct.Get();
+                if (!Set->bIsClass || !Struct || !ClassDesc || !ClassDesc->IsClass() || !((UObject*)Self)->IsA((UClass*)Struct))
+                    luaL_error(L, "instance of %s expected", Struct ? TCHAR_TO_UTF8(*Struct->GetName()) : "unloaded type");
+            }
+            lua_pop(L, 1);
+            return Self;
+        }
+
+        static int PropSet_Get(lua_State* L)
+        {
+            const auto Set = (FPropSet*)luaL_checkudata(L, 1, "FPropSet");
+            void* Self = CheckPropSetInstance(L, Set);
+            const int32 Num = (int32)Set->Num;
+            luaL_checkstack(L, Num, nullptr);
+            const auto Accessors = Set->GetAccessors();
+            for (int32 i = 0; i < Num; ++i)
+                ReadProperty(L, Accessors[i], Self);
+            return Num;
+        }
+
+        static int PropSet_Set(lua_State* L)
+        {
+            const auto Set = (FPropSet*)luaL_checkudata(L, 1, "FPropSet");
+            void* Self = CheckPropSetInstance(L, Set);
+            const int32 Num = FMath::Min((int32)Set->Num, lua_gettop(L) - 2);
+            const auto Accessors = Set->GetAccessors();
+            for (int32 i = 0; i < Num; ++i)
+            {
+                if (!lua_isnil(L, i + 3))
+                    WriteProperty(L, Accessors[i], Self, i + 3);
+            }
+            return 0;
+        }
+
+        static int PropSet(lua_State* L)
+        {
+            luaL_checktype(L, 2, LUA_TTABLE);
+
+            // UE.AActor / UE.FVector or a UClass / UScriptStruct object
+            const auto Struct = lua_type(L, 1) == LUA_TUSERDATA ? Cast<UStruct>(GetUObject(L, 1)) : nullptr;
+            if (Struct)
+            {
+                const auto& Env = FLuaEnv::FindEnvChecked(L);
+                if (!Env.GetClassRegistry()->PushMetatable(L, TCHAR_TO_UTF8(*LowLevel::GetMetatableName(Struct))))
+                    return luaL_error(L, "failed to register type %s", TCHAR_TO_UTF8(*Struct->GetName()));
+            }
+            else if (!PushInstanceMetatable(L, 1))
+            {
+                return luaL_error(L, "invalid class");
+            }
+
+            const int32 MetatableIndex = lua_gettop(L);
+            lua_pushstring(L, "ClassDesc");
+            lua_rawget(L, MetatableIndex);
+            const auto ClassDesc = (FClassDesc*)lua_touserdata(L, -1);
+            lua_pop(L, 1);
+            if (!ClassDesc)
+                return luaL_error(L, "invalid class");
+
+            const int32 Num = (int32)lua_rawlen(L, 2);
+            const auto Set = (FPropSet*)lua_newuserdatauv(L, sizeof(FPropSet) + Num * sizeof(FPropertyAccessor*), 2);
+            new(&Set->Struct) TWeakObjectPtr<UStruct>(ClassDesc->AsStruct());
+            Set->bIsClass = ClassDesc->IsClass();
+            Set->Num = Num;
+            lua_createtable(L, Num, 0);
+            for (int32 i = 1; i <= Num; ++i)
+            {
+                if (lua_rawgeti(L, 2, i) != LUA_TSTRING)
+                    return luaL_error(L, "property name must be a string");
+
+                PushMetatableField(L, MetatableIndex, -1);
+                Set->GetAccessors()[i - 1] = CheckAccessor(L, -1, -2);
+                lua_rawseti(L, -3, i);
+                lua_pop(L, 1);
+            }
+            lua_setiuservalue(L, -2, 1);
+            lua_pushvalue(L, MetatableIndex);
+            lua_setiuservalue(L, -2, 2);
+
+            if (luaL_newmetatable(L, "FPropSet"))
+            {
+                lua_newtable(L);
+                lua_pushcfunction(L, PropSet_Get);
+                lua_setfield(L, -2, "Get");
+                lua_pushcfunction(L, PropSet_Set);
+                lua_setfield(L, -2, "Set");
+                lua_setfield(L, -2, "__index");
+            }
+            lua_setmetatable(L, -2);
+            return 1;
+        }
+
+#pragma endregion
+
         static constexpr luaL_Reg UnLua_Functions[] = {
             {"Log", LogInfo},
             {"LogWarn", LogWarn},
@@ -88,6 +302,10 @@ namespace UnLua
             {"HotReload", HotReload},
             {"Ref", Ref},
             {"Unref", Unref},
+            {"StartCoroutine", StartCoroutine},
+            {"GetProps", GetProps},
+            {"SetProps", SetProps},
+            {"PropSet", PropSet},
             {"FTextEnabled", nullptr},
             {NULL, NULL}
         };
@@ -96,12 +314,8 @@ namespace UnLua
 
         int32 GetUProperty(lua_State* L)
         {
-            auto Ptr = lua_touserdata(L, 2);
-            if (!Ptr)
-                return 0;
-
-            auto Property = static_cast<TSharedPtr<UnLua::ITypeOps>*>(Ptr);
-            if (!Property->IsValid())
+            const auto Accessor = FPropertyAccessor::Get(L, 2);
+            if (!Accessor || !Accessor->IsValid())
                 return 0;
 
             auto Self = GetCppInstance(L, 1);
@@ -109,33 +323,29 @@ namespace UnLua
                 return 0;
 
             if (UnLua::LowLevel::IsReleasedPtr(Self))
-                return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to read property '%s' on released object"), *(*Property)->GetName())));
+                return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to read property '%s' on released object"), *Accessor->GetName())));
 
-            if (!LowLevel::CheckPropertyOwner(L, (*Property).Get(), Self))
+            if (!Accessor->CheckOwner(L, Self))
                 return 0;
 
-            (*Property)->ReadValue_InContainer(L, Self, false);
+            Accessor->Read(L, Self);
             return 1;
         }
 
         int32 SetUProperty(lua_State* L)
         {
-            auto Ptr = lua_touserdata(L, 2);
-            if (!Ptr)
-                return 0;
-
-            auto Property = static_cast<TSharedPtr<UnLua::ITypeOps>*>(Ptr);
-            if (!Property->IsValid())
+            const auto Accessor = FPropertyAccessor::Get(L, 2);
+            if (!Accessor || !Accessor->IsValid())
                 return 0;
 
             auto Self = GetCppInstance(L, 1);
             if (LowLevel::IsReleasedPtr(Self))
-                return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to write property '%s' on released object"), *(*Property)->GetName())));
+                return luaL_error(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("attempt to write property '%s' on released object"), *Accessor->GetName())));
 
-            if (!LowLevel::CheckPropertyOwner(L, (*Property).Get(), Self))
+            if (!Accessor->CheckOwner(L, Self))
                 return 0;
 
-            (*Property)->WriteValue_InContainer(L, Self, 3);
+            Accessor->Write(L, Self, 3);
             return 0;
         }
 
@@ -17,6 +17,7 @@
 #include "Components/InputComponent.h"
 #include "Animation/AnimInstance.h"
 #include "Engine/LevelScriptActor.h"
+#include "Engine/World.h"
 #include "UnLuaManager.h"
 #include "LowLevel.h"
 #include "LuaEnv.h"
@@ -26,6 +27,7 @@
 #include "LuaFunction.h"
 #include "ObjectReferencer.h"
 
+bool UUnLuaManager::bEnableLazyBinding = false;
 
 static const TCHAR* SReadableInputEvent[] = { TEXT("Pressed"), TEXT("Released"), TEXT("Repeat"), TEXT("DoubleClick"), TEXT("Axis"), TEXT("Max") };
 
@@ -91,7 +93,31 @@ bool UUnLuaManager::Bind(UObject *Object, const TCHAR *InModuleName, int32 Initi
 
     // create a Lua instance for this UObject
     Env->GetObjectRegistry()->Bind(Class);
+
+    if (bEnableLazyBinding && InitializerTableRef == LUA_NOREF && Object != Class && !Object->HasAnyFlags(RF_ClassDefaultObject))
+    {
+        // 延迟到Lua首次访问时再创建实例，定义了Initialize的对象在帧开始时统一初始化
+        Env->GetObjectRegistry()->BindLazily(Object);
+
+        static const FName InitializeName = FName("Initialize");
+        const auto BindInfo = Classes.Find(Class);
+        if (BindInfo && BindInfo->LuaFunctions.Contains(InitializeName))
+        {
+            PendingInitializes.Add(Object);
+            if (!OnWorldTickStartHandle.IsValid())
+                OnWorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UUnLuaManager::OnWorldTickStart);
+        }
+        return true;
+    }
+
     Env->GetObjectRegistry()->Bind(Object);
+    CallInitialize(Object, InitializerTableRef);
+    return true;
+}
+
+void UUnLuaManager::CallInitialize(UObject *Object, int32 InitializerTableRef)
+{
+    lua_State *L = Env->GetMainState();
 
     // try call user first user function handler
     int32 FunctionRef = PushFunction(L, Object, "Initialize");                  // push hard coded Lua function 'Initialize'
@@ -112,8 +138,25 @@ bool UUnLuaManager::Bind(UObject *Object, const TCHAR *InModuleName, int32 Initi
         }
         luaL_unref(L, LUA_REGISTRYINDEX, FunctionRef);
     }
+}
 
-    return true;
+void UUnLuaManager::OnWorldTickStart(UWorld *World, ELevelTick TickType, float DeltaTime)
+{
+    FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
+    OnWorldTickStartHandle.Reset();
+
+    if (!Env)
+        return;
+
+    // Initialize里可能绑定新的对象，先把列表移出来
+    const TArray<FWeakObjectPtr> Objects = MoveTemp(PendingInitializes);
+    PendingInitializes.Reset();
+    for (const auto& ObjectPtr : Objects)
+    {
+        UObject* Object = ObjectPtr.Get();
+        if (Object)
+            Env->GetObjectRegistry()->GetBoundRef(Object); // 创建实例时会调用Initialize
+    }
 }
 
 void UUnLuaManager::NotifyUObjectDeleted(const UObjectBase* Object)
@@ -135,6 +178,12 @@ void UUnLuaManager::Cleanup()
 {
     Env = nullptr;
     Classes.Empty();
+    PendingInitializes.Empty();
+    if (OnWorldTickStartHandle.IsValid())
+    {
+        FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
+        OnWorldTickStartHandle.Reset();
+    }
 }
 
 int UUnLuaManager::GetBoundRef(const UClass* Class)
@@ -298,6 +347,7 @@ bool UUnLuaManager::BindClass(UClass* Class, const FString& InModuleName, FStrin
     lua_settop(L, Top);
 
     auto& BindInfo = Classes.Add(Class);
+    Env->AddKnownObject(Class);
     BindInfo.Class = Class;
     BindInfo.ModuleName = InModuleName;
     BindInfo.TableRef = Ref;
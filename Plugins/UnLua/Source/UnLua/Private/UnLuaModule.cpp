@@ -32,9 +32,11 @@
 #include "UnLuaDebugBase.h"
 #include "UnLuaInterface.h"
 #include "UnLuaSettings.h"
+#include "UnLuaManager.h"
 #include "GameFramework/PlayerController.h"
 #include "Registries/ClassRegistry.h"
 #include "Registries/EnumRegistry.h"
+#include "ReflectionUtils/FunctionDesc.h"
 
 #define LOCTEXT_NAMESPACE "FUnLuaModule"
 
@@ -106,6 +108,12 @@ namespace UnLua
                 EnvLocator->AddToRoot();
                 FDeadLoopCheck::Timeout = Settings.DeadLoopCheck;
                 FDanglingCheck::Enabled = Settings.DanglingCheck;
+                FFunctionDesc::bEnableNativeFastPath = Settings.bEnableNativeFastPath;
+                FFunctionDesc::bEnableStructParamViews = Settings.bEnableStructParamViews;
+                UUnLuaManager::bEnableLazyBinding = Settings.bEnableLazyBinding;
+
+                // 提前创建以监听蓝图重编译，维护分派缓存的世代号
+                FLuaOverrides::Get();
 
                 for (const auto Class : TObjectRange<UClass>())
                 {
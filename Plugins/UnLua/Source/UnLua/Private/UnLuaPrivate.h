@@ -45,8 +45,10 @@ inline FString UnLuaUnsafePrintf(const TCHAR* Fmt, ...)
 
 #if STATS
 DECLARE_STATS_GROUP(TEXT("UnLua"), STATGROUP_UnLua, STATCAT_Advanced);
+DECLARE_STATS_GROUP(TEXT("UnLua Calls"), STATGROUP_UnLuaCalls, STATCAT_Advanced);
 DECLARE_MEMORY_STAT_EXTERN(TEXT("Lua Memory"), STAT_UnLua_Lua_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
-DECLARE_MEMORY_STAT_EXTERN(TEXT("Persistent Parameter Buffer Memory"), STAT_UnLua_PersistentParamBuffer_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Parameter Buffer Arena Memory"), STAT_UnLua_ParamBufferArena_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Parameter Buffer Arena High Water"), STAT_UnLua_ParamBufferArenaHighWater_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
 DECLARE_MEMORY_STAT_EXTERN(TEXT("OutParmRec Memory"), STAT_UnLua_OutParmRec_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
 DECLARE_MEMORY_STAT_EXTERN(TEXT("Container Element Cache Memory"), STAT_UnLua_ContainerElementCache_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
 
@@ -61,6 +63,9 @@ DECLARE_MEMORY_STAT_EXTERN(TEXT("Container Element Cache Memory"), STAT_UnLua_Co
     const auto _FreedSize = FMemory::GetAllocSize(PointerName); \
     DEC_MEMORY_STAT_BY(STAT_UnLua_##CounterName##_Memory, _FreedSize);
 
+#define UNLUA_STAT_MEMORY_SET(Value, CounterName) \
+    SET_MEMORY_STAT(STAT_UnLua_##CounterName##_Memory, Value);
+
 #define UNLUA_STAT_MEMORY_REALLOC(Pointer, NewPointer, CounterName) \
     struct FReallocGuard { \
         uint32 OldSize; \
@@ -90,6 +95,7 @@ DECLARE_MEMORY_STAT_EXTERN(TEXT("Container Element Cache Memory"), STAT_UnLua_Co
 
 #define UNLUA_STAT_MEMORY_ALLOC(Pointer, CounterName)
 #define UNLUA_STAT_MEMORY_FREE(PointerName, CounterName)
+#define UNLUA_STAT_MEMORY_SET(Value, CounterName)
 #define UNLUA_STAT_MEMORY_REALLOC(Pointer, NewPointer, CounterName)
 
 #define UNLUA_DECLARE_CYCLE_STAT(FriendlyName, StatName)
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "Engine/EngineBaseTypes.h"
+#include "Containers/Queue.h"
 #include "Registries/ObjectRegistry.h"
 #include "Registries/ClassRegistry.h"
 #include "Registries/DelegateRegistry.h"
@@ -26,9 +27,15 @@
 #include "lua.hpp"
 #include "ObjectReferencer.h"
 #include "HAL/Platform.h"
+#include "Misc/EngineVersionComparison.h"
 #include "LuaDanglingCheck.h"
 #include "LuaDeadLoopCheck.h"
+#include "LuaAsyncHook.h"
+#include "LuaNameCache.h"
+#include "LuaModuleResolver.h"
+#include "LuaBytecodeCache.h"
 #include "LuaModuleLocator.h"
+#include "ReflectionUtils/ParamBufferAllocator.h"
 
 namespace UnLua
 {
@@ -56,9 +63,23 @@ namespace UnLua
 
         static TMap<lua_State*, FLuaEnv*>& GetAll();
 
-        static FLuaEnv* FindEnv(const lua_State* L);
+        /**
+         * Get the env which owns the lua state. The env pointer lives in the extra space of the main thread,
+         * and new threads inherit it, so it's a single pointer load.
+         */
+        static FORCEINLINE FLuaEnv* FindEnv(const lua_State* L)
+        {
+            if (!L)
+                return nullptr;
+            return *(FLuaEnv**)lua_getextraspace(const_cast<lua_State*>(L));
+        }
 
-        static FLuaEnv& FindEnvChecked(const lua_State* L);
+        static FORCEINLINE FLuaEnv& FindEnvChecked(const lua_State* L)
+        {
+            FLuaEnv* Env = *(FLuaEnv**)lua_getextraspace(const_cast<lua_State*>(L));
+            check(Env);
+            return *Env;
+        }
 
         void Start(const TMap<FString, UObject*>& Args = {});
 
@@ -70,6 +91,17 @@ namespace UnLua
 
         virtual void NotifyUObjectDeleted(const UObjectBase* ObjectBase, int32 Index) override;
 
+        /**
+         * Mark an object recorded by this env, deletions of unmarked objects are not dispatched to the registries
+         */
+        FORCEINLINE void AddKnownObject(const UObjectBase* Object)
+        {
+            const int32 Index = GUObjectArray.ObjectToIndex(Object);
+            if (Index >= KnownObjects.Num())
+                KnownObjects.Add(false, Index + 1 - KnownObjects.Num());
+            KnownObjects[Index] = true;
+        }
+
         virtual void OnUObjectArrayShutdown() override;
 
         virtual bool TryBind(UObject* Object);
@@ -84,13 +116,31 @@ namespace UnLua
 
         FORCEINLINE lua_State* GetMainState() const { return L; }
 
-        void AddThread(lua_State* Thread, int32 ThreadRef);
-
-        int32 FindOrAddThread(lua_State* Thread);
-
-        int32 FindThread(const lua_State* Thread);
-
-        void ResumeThread(int32 ThreadRef);
+        /**
+         * Reserve a linkage to resume the thread when a latent action completes
+         *
+         * @return - the linkage, LUA_REFNIL if the thread is the main thread
+         */
+        int32 AddThread(lua_State* Thread);
+
+        /**
+         * Resume the thread waiting on the linkage, the linkage is released
+         */
+        void ResumeThread(int32 Linkage);
+
+        /**
+         * Run a function on a pooled coroutine, the function and its arguments are on the top of the stack
+         */
+        void StartCoroutine(lua_State* InL, int32 NumArgs);
+
+        /**
+         * Get a new UUID for latent actions of this env
+         */
+        FORCEINLINE int32 NewLatentUUID()
+        {
+            LatentUUID = LatentUUID == MAX_int32 ? 1 : LatentUUID + 1;
+            return LatentUUID;
+        }
 
         UUnLuaManager* GetManager();
 
@@ -112,6 +162,18 @@ namespace UnLua
 
         FORCEINLINE FDeadLoopCheck* GetDeadLoopCheck() const { return DeadLoopCheck; }
 
+        FORCEINLINE FLuaAsyncHook* GetAsyncHook() const { return AsyncHook; }
+
+        FORCEINLINE FParamBufferArena* GetParamBufferArena() const { return ParamBufferArena; }
+
+        FORCEINLINE FNameCache* GetNameCache() const { return NameCache; }
+
+        /** Registry reference of the weak table caching userdata of struct pointers */
+        FORCEINLINE int32 GetStructMapRef() const { return StructMapRef; }
+
+        /** Registry reference of the weak table caching tables of static arrays */
+        FORCEINLINE int32 GetArrayMapRef() const { return ArrayMapRef; }
+
         void AddLoader(const FLuaFileLoader Loader);
 
         void AddBuiltInLoader(const FString InName, lua_CFunction Loader);
@@ -129,6 +191,8 @@ namespace UnLua
 
         static int LoadFromFileSystem(lua_State* L);
 
+        static int CreateCoroutine(lua_State* L);
+
         static void* DefaultLuaAllocator(void* ud, void* ptr, size_t osize, size_t nsize);
 
         virtual lua_Alloc GetLuaAllocator() const;
@@ -150,20 +214,44 @@ namespace UnLua
 
         bool LoadBuffer(lua_State* InL, const char* Buffer, const size_t Size, const char* InName);
 
+        /** Load a module chunk through the bytecode cache if it is enabled, the chunk name is the cache key unless one is given */
+        bool LoadModule(lua_State* InL, const TArray<uint8>& Chunk, const FString& ChunkName, const FString* CacheKey = nullptr);
+
         void OnAsyncLoadingFlushUpdate();
 
         void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaTime);
 
+#if WITH_EDITOR && !UE_VERSION_OLDER_THAN(5, 1, 0)
+        void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+#endif
+
+        struct FBindDecision
+        {
+            bool bImplUnluaInterface = false;
+            FString ModuleName; // empty when the class should not be bound statically
+        };
+
+        /** Find or compute the cached binding decision for a class, returns nullptr when it cannot be decided yet */
+        const FBindDecision* GetBindDecision(UClass* Class, UObject* Object);
+
         void RegisterDelegates();
 
+        void ReleaseThreadSlot(lua_State* InL, int32 Index);
+
+        /** Take a thread from the pool or create one, it's pushed onto the stack of InL */
+        lua_State* NewThread(lua_State* InL);
+
+        void RecycleThread(lua_State* InL, lua_State* Thread);
+
         void UnRegisterDelegates();
 
         static TMap<lua_State*, FLuaEnv*> AllEnvs;
         TMap<FString, lua_CFunction> BuiltinLoaders;
         TArray<FLuaFileLoader> CustomLoaders;
-        TArray<FWeakObjectPtr> Candidates; // binding candidates during async loading
+        TQueue<FWeakObjectPtr, EQueueMode::Mpsc> CandidateQueue; // binding candidates produced by the async loading thread
+        TArray<FWeakObjectPtr> PendingCandidates; // candidates waiting for post load or a time budget, game thread only
+        double AsyncBindTimeBudget = 0; // seconds, 0 means unlimited
         ULuaModuleLocator* ModuleLocator;
-        FCriticalSection CandidatesLock;
         FObjectReferencer AutoObjectReference;
         FObjectReferencer ManualObjectReference;
         UUnLuaManager* Manager = nullptr;
@@ -176,8 +264,27 @@ namespace UnLua
         FEnumRegistry* EnumRegistry;
         FDanglingCheck* DanglingCheck;
         FDeadLoopCheck* DeadLoopCheck;
-        TMap<lua_State*, int32> ThreadToRef;
-        TMap<int32, lua_State*> RefToThread;
+        FLuaAsyncHook* AsyncHook;
+        FParamBufferArena* ParamBufferArena;
+        FNameCache* NameCache;
+        FLuaModuleResolver ModuleResolver;
+        FLuaBytecodeCache* BytecodeCache = nullptr;
+        struct FThreadSlot
+        {
+            lua_State* Thread = nullptr;
+            int32 Serial = 1;
+        };
+        TArray<FThreadSlot> ThreadSlots;
+        TArray<int32> FreeThreadSlots;
+        TArray<lua_State*> ThreadPool;
+        int32 ThreadsRef = LUA_NOREF;      // anchors waiting threads with their slot index + 1, and pooled threads with true
+        int32 OwnedThreadsRef = LUA_NOREF; // weak keyed table of threads created by UnLua, recycled when they finish
+        TBitArray<> KnownObjects;     // indexed by GUObjectArray index
+        TMap<const UClass*, FBindDecision> BindDecisions; // game thread only
+        FBindDecision UncachedDecision; // the last decision when decisions can't be cached, see GetBindDecision
+        int32 StructMapRef = LUA_NOREF;
+        int32 ArrayMapRef = LUA_NOREF;
+        int32 LatentUUID = 0;
         FDelegateHandle OnAsyncLoadingFlushUpdateHandle;
         TArray<UInputComponent*> CandidateInputComponents;
         FDelegateHandle OnWorldTickStartHandle;
@@ -262,6 +262,13 @@ namespace UnLua
      */
     UNLUA_API void* GetSmartPointer(lua_State *L, int32 Index);
 
+    /**
+     * Push an accessor of a property to be cached in a metatable
+     *
+     * @param Property - the property
+     */
+    UNLUA_API void PushPropertyAccessor(lua_State *L, const TSharedPtr<ITypeOps> &Property);
+
     /**
      * Allocate user data
      *
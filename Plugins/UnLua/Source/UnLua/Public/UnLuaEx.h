@@ -202,8 +202,7 @@ namespace UnLua
         {
             // make sure the meta table is on the top of the stack
             lua_pushstring(L, TCHAR_TO_UTF8(*Name));
-            const auto Userdata = NewSmartPointer(L, sizeof(TSharedPtr<FExportedProperty>), "TSharedPtr");
-            new(Userdata) TSharedPtr<FExportedProperty>(this->AsShared());
+            PushPropertyAccessor(L, this->AsShared());
             lua_rawset(L, -3);
         }
 
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "InputCoreTypes.h"
+#include "Engine/EngineBaseTypes.h"
 #include "Engine/DynamicBlueprintBinding.h"
 #include "lua.hpp"
 #include "UnLuaCompatibility.h"
@@ -38,6 +39,9 @@ public:
 
     bool Bind(UObject *Object, const TCHAR *InModuleName, int32 InitializerTableRef = LUA_NOREF);
 
+    /* 调用对象绑定模块里的Initialize函数 */
+    void CallInitialize(UObject *Object, int32 InitializerTableRef = LUA_NOREF);
+
     void NotifyUObjectDeleted(const UObjectBase *Object);
 
     void Cleanup();
@@ -91,6 +95,9 @@ public:
     UFUNCTION(BlueprintImplementableEvent)
     void TriggerAnimNotify();
 
+    /** Whether Lua instances of bound objects are created on first use, see UUnLuaSettings */
+    static bool bEnableLazyBinding;
+
 private:
     /* 将一个UClass绑定到Lua模块，根据这个模块定义的函数列表来覆盖上面的UFunction */
     bool BindClass(UClass *Class, const FString &InModuleName, FString &Error);
@@ -103,6 +110,9 @@ private:
     void ReplaceVectorAxisInputs(AActor *Actor, UInputComponent *InputComponent, TSet<FName> &LuaFunctions);
     void ReplaceGestureInputs(AActor *Actor, UInputComponent *InputComponent, TSet<FName> &LuaFunctions);
 
+    /* 每帧开始时为延迟绑定且定义了Initialize的对象统一创建实例并初始化 */
+    void OnWorldTickStart(UWorld *World, ELevelTick TickType, float DeltaTime);
+
     struct FClassBindInfo
     {
         UClass* Class;
@@ -114,6 +124,9 @@ private:
 
     TMap<UClass*, FClassBindInfo> Classes;
 
+    TArray<FWeakObjectPtr> PendingInitializes;
+    FDelegateHandle OnWorldTickStartHandle;
+
     TSet<FName> DefaultAxisNames;
     TSet<FName> DefaultActionNames;
     TArray<FKey> AllKeys;
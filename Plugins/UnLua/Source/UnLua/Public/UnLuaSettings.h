@@ -40,6 +40,50 @@ public:
     UPROPERTY(Config, EditAnywhere, Category="Runtime")
     bool DanglingCheck = false;
 
+    /**
+     * Call simple native UFunctions directly through their native thunk instead of ProcessEvent.
+     * Only applies to non-net, non-latent functions whose parameters are numeric, bool, enum, object or small POD structs.
+     */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    bool bEnableNativeFastPath = false;
+
+    /**
+     * Pass struct parameters of overridden functions and delegates to Lua as views into the parameter frame instead of copies.
+     * A view is invalidated when the call returns, use its Copy() method to keep the value.
+     */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    bool bEnableStructParamViews = false;
+
+    /**
+     * Time budget in milliseconds per async loading flush update for binding objects created on the async loading thread.
+     * Objects left over are bound on following updates. 0 means unlimited.
+     */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime", Meta=(ClampMin="0"))
+    float AsyncBindTimeBudget = 0;
+
+    /**
+     * Create the Lua instance of a bound object on its first use from Lua instead of at construction.
+     * Objects whose module defines Initialize are initialized in a batch at the start of the next world tick, or earlier
+     * if Lua uses them first. Without a ticking world they stay pending until their first use.
+     */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    bool bEnableLazyBinding = false;
+
+    /** Cache compiled bytecode of modules loaded from the file system or custom loaders, so unchanged scripts skip the Lua parser. */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    bool bEnableBytecodeCache = false;
+
+    /** Strip debug information from cached bytecode. Errors raised by stripped chunks have no line numbers. */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime", Meta=(EditCondition="bEnableBytecodeCache"))
+    bool bStripBytecode = false;
+
+    /**
+     * Directory of the bytecode cache relative to the project dir, Saved/UnLua/Bytecode when empty.
+     * Point it to a directory staged with the build to ship precompiled scripts.
+     */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime", Meta=(EditCondition="bEnableBytecodeCache"))
+    FString BytecodeCacheDirectory;
+
     /** Whether to print all Lua env stacks on crash. */
     UPROPERTY(Config, EditAnywhere, Category="Runtime")
     bool bPrintLuaStackOnSystemError = true;
@@ -21,6 +21,7 @@
 #include "UnLua.h"
 #include "UnLuaEditorSettings.h"
 #include "UnLuaFunctionLibrary.h"
+#include "LuaModuleResolver.h"
 #include "Common/UdpSocketBuilder.h"
 #include "Interfaces/IPluginManager.h"
 
@@ -111,6 +112,8 @@ FString UUnLuaEditorFunctionLibrary::GetCurrentVersion()
 
 void UUnLuaEditorFunctionLibrary::OnLuaFilesModified(const TArray<FFileChangeData>& FileChanges)
 {
+    UnLua::FLuaModuleResolver::InvalidateAll();
+
     const auto& Settings = *GetDefault<UUnLuaEditorSettings>();
     if (Settings.HotReloadMode != EHotReloadMode::Auto)
         return;
@@ -62,7 +62,7 @@ public:
     UPROPERTY(config, EditAnywhere, Category = "Build")
     bool bEnableUnrealInsights = false;
 
-    /** Enable persistent buffer for UFunction's parameters. (Requires restart to take effect) */
+    /** Enable per-env persistent arena for UFunction's parameter buffers. (Requires restart to take effect) */
     UPROPERTY(config, EditAnywhere, Category = "Build")
     bool bEnablePersistentParamBuffer = true;
 